@@ -1,9 +1,51 @@
 #include "AlternativeRoute.h"
 #include "ShortestPath.h"
+#include "KShortestPaths.h"
+#include "SearchWorkspace.h"
+#include <algorithm>
+#include <limits>
 #include <iostream>
 
 using namespace std;
 
+namespace {
+    const uint32_t NONE = CompactGraph::INVALID;
+
+    /**
+     * @brief Dijkstra một - tất cả (xuôi hoặc ngược) từ root; khi chốt được anchor ở
+     *        khoảng cách D thì chỉ đi tiếp tới (1 + stretch) * D. ws giữ khoảng cách và
+     *        Edge cha (xuôi) hoặc Edge kế tiếp về root (ngược). Trả về D, vô cực nếu
+     *        không tới được anchor.
+     */
+    double boundedTree(const CompactGraph& g, uint32_t root, uint32_t anchor, bool backward,
+                       double stretch, SearchWorkspace& ws) {
+        double limit = numeric_limits<double>::infinity();
+        double anchorDist = limit;
+        ws.reset(g.numNodes());
+        ws.set(root, 0, NONE);
+        ws.push(0, root);
+        while (!ws.empty()) {
+            auto [d, u] = ws.pop();
+            if (d > ws.dist(u)) continue;
+            if (d > limit) break;
+            if (u == anchor) {
+                anchorDist = d;
+                limit = (1 + stretch) * d;
+            }
+            auto relax = [&](ArcView arc) {
+                double nd = d + arc.weight;
+                if (nd < ws.dist(arc.target)) {
+                    ws.set(arc.target, nd, arc.edge);
+                    ws.push(nd, arc.target);
+                }
+            };
+            if (backward) for (ArcView arc : g.inArcs(u)) relax(arc);
+            else for (ArcView arc : g.outArcs(u)) relax(arc);
+        }
+        return anchorDist;
+    }
+}
+
 AlternativeRoute::AlternativeRoute(RoadMap& map)
     : map_(map) {}
 
@@ -11,10 +53,11 @@ void AlternativeRoute::suggestAlternative(const string& blockedEdgeId,
                                           const string& start,
                                           const string& goal) {
 
-    map_.blockEdge(blockedEdgeId);
+    ClosureSet closures(map_.graph(), vector<string>{blockedEdgeId});
 
     vector<string> path;
     ShortestPath sp(map_);
+    sp.setClosures(&closures);
     double t = sp.findShortestPath(start, goal, path);
 
     if (t < 0) cout << "❌ Không có tuyến thay thế.\n";
@@ -23,8 +66,6 @@ void AlternativeRoute::suggestAlternative(const string& blockedEdgeId,
         for (auto &p : path) cout << p << " ";
         cout << "\nThời gian: " << t << "\n";
     }
-
-    map_.unblockAll();
 }
 
 AlternativeRouteResult AlternativeRoute::findAlternativeRoute(const string& blockedEdgeId,
@@ -35,18 +76,18 @@ AlternativeRouteResult AlternativeRoute::findAlternativeRoute(const string& bloc
     result.success = false;
     result.travelTime = -1;
     
-    // Chặn edge
-    if (! map_.blockEdge(blockedEdgeId)) {
+    // Đóng edge chỉ cho truy vấn này, bản đồ không bị sửa
+    if (! map_.hasEdge(blockedEdgeId)) {
         result.errorMessage = "Không thể chặn edge " + blockedEdgeId;
         return result;
     }
+    ClosureSet closures(map_.graph(), vector<string>{blockedEdgeId});
     
     // Tìm đường thay thế
     ShortestPath sp(map_);
-    double t = sp.findShortestPath(start, goal, result.path);
-    
-    // Bỏ chặn edge
-    map_.unblockAll();
+    sp.setClosures(&closures);
+    double t = sp.findRoute(start, goal, result.route);
+    result.path = result.route.nodePath(map_.graph());
     
     if (t < 0) {
         result.success = false;
@@ -57,4 +98,137 @@ AlternativeRouteResult AlternativeRoute::findAlternativeRoute(const string& bloc
     }
     
     return result;
-}
\ No newline at end of file
+}
+
+vector<AlternativeRouteResult> AlternativeRoute::findTopRoutes(const string& start,
+                                                               const string& goal,
+                                                               size_t k) {
+    vector<AlternativeRouteResult> results;
+    KShortestPaths ksp(map_);
+    for (EdgeRoute& route : ksp.find(start, goal, k)) {
+        AlternativeRouteResult result;
+        result.success = true;
+        result.travelTime = route.travelTime();
+        result.path = route.nodePath(map_.graph());
+        result.route = std::move(route);
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+/**
+ * @brief Via-node/plateau: xem mô tả ở AlternativeRoute.h. Edge u -> v thuộc plateau
+ *        khi nó là Edge cha của v trên cây xuôi và Edge kế tiếp của u trên cây ngược.
+ */
+vector<AlternativeRouteResult> AlternativeRoute::findViaAlternatives(const string& start,
+                                                                     const string& goal,
+                                                                     size_t maxAlternatives,
+                                                                     const ViaRouteOptions& options) {
+    vector<AlternativeRouteResult> results;
+    const CompactGraph& g = map_.graph();
+    uint32_t s = g.findNode(start);
+    uint32_t t = g.findNode(goal);
+    if (s == NONE || t == NONE || s == t || maxAlternatives == 0) return results;
+
+    const double INF = numeric_limits<double>::infinity();
+    SearchWorkspace& fw = SearchWorkspace::forThread(0);
+    SearchWorkspace& bw = SearchWorkspace::forThread(1);
+
+    const double D = boundedTree(g, t, s, true, options.maxStretch, bw);
+    if (D == INF) return results;
+    const double limit = (1 + options.maxStretch) * D;
+    boundedTree(g, s, t, false, options.maxStretch, fw);
+
+    auto onPlateau = [&](uint32_t e) {
+        uint32_t u = g.tail[e], v = g.head[e];
+        return fw.reached(v) && bw.reached(u) && fw.parent(v) == e && bw.parent(u) == e;
+    };
+
+    // Mỗi plateau được đại diện bởi node đầu của nó (không có Edge plateau đi vào)
+    struct Plateau {
+        uint32_t first;
+        double length;
+        double total;       // thời gian của tuyến via
+    };
+    vector<Plateau> plateaus;
+    for (uint32_t e = 0; e < g.numEdges(); e++) {
+        if (!onPlateau(e)) continue;
+        uint32_t first = g.tail[e];
+        if (fw.parent(first) != NONE && onPlateau(fw.parent(first))) continue;
+        double total = fw.dist(first) + bw.dist(first);
+        if (total > limit) continue;
+        uint32_t last = first;
+        while (bw.parent(last) != NONE && onPlateau(bw.parent(last))) last = g.head[bw.parent(last)];
+        plateaus.push_back({first, fw.dist(last) - fw.dist(first), total});
+    }
+
+    // Tuyến qua node v: cây xuôi s -> v rồi cây ngược v -> t
+    auto viaEdges = [&](uint32_t v) {
+        vector<uint32_t> edges;
+        for (uint32_t u = v; u != s; u = g.tail[fw.parent(u)]) edges.push_back(fw.parent(u));
+        reverse(edges.begin(), edges.end());
+        for (uint32_t u = v; u != t; u = g.head[bw.parent(u)]) edges.push_back(bw.parent(u));
+        return edges;
+    };
+
+    // Edge đã thuộc một tuyến được chọn (bắt đầu với đường ngắn nhất)
+    vector<uint8_t> used(g.numEdges(), 0);
+    for (uint32_t e : viaEdges(s)) used[e] = 1;
+    auto sharing = [&](const vector<uint32_t>& edges) {
+        double shared = 0;
+        for (uint32_t e : edges)
+            if (used[e]) shared += g.weight[e];
+        return shared;
+    };
+
+    struct Candidate {
+        double score;
+        size_t plateau;
+    };
+    vector<Candidate> candidates;
+    for (size_t i = 0; i < plateaus.size(); i++) {
+        const Plateau& p = plateaus[i];
+        if (p.length < options.minPlateau * D) continue;
+        double shared = sharing(viaEdges(p.first));
+        if (shared > options.maxSharing * D) continue;
+        candidates.push_back({2 * p.total + shared - p.length, i});
+    }
+    sort(candidates.begin(), candidates.end(),
+         [](const Candidate& a, const Candidate& b) { return a.score < b.score; });
+
+    vector<uint32_t> visited(g.numNodes(), 0);
+    uint32_t mark = 0;
+    for (const Candidate& c : candidates) {
+        if (results.size() >= maxAlternatives) break;
+        vector<uint32_t> edges = viaEdges(plateaus[c.plateau].first);
+
+        // Phần trùng tính lại với cả các tuyến vừa chọn; bỏ tuyến có vòng lặp
+        if (sharing(edges) > options.maxSharing * D) continue;
+        mark++;
+        bool loop = false;
+        visited[s] = mark;
+        for (uint32_t e : edges) {
+            if (visited[g.head[e]] == mark) {
+                loop = true;
+                break;
+            }
+            visited[g.head[e]] = mark;
+        }
+        if (loop) continue;
+
+        AlternativeRouteResult result;
+        result.success = true;
+        result.route.source = s;
+        double time = 0;
+        for (uint32_t e : edges) {
+            time += g.weight[e];
+            result.route.steps.push_back({e, time});
+            used[e] = 1;
+        }
+        result.route.cost = time;
+        result.travelTime = time;
+        result.path = result.route.nodePath(g);
+        results.push_back(std::move(result));
+    }
+    return results;
+}
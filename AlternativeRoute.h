@@ -1,16 +1,26 @@
 #pragma once
 #include "RoadMap.h"
+#include "ShortestPath.h"
 #include <string>
 #include <vector>
 
 struct AlternativeRouteResult {
     bool success;
     std::vector<std::string> path;
+    EdgeRoute route;            // cùng tuyến, theo Edge kèm thời gian tích lũy
     double travelTime;
     std::string blockedEdgeId;
     std::string errorMessage;
 };
 
+// Ngưỡng chấp nhận tuyến thay thế của findViaAlternatives (theo tỉ lệ với thời
+// gian D của đường ngắn nhất)
+struct ViaRouteOptions {
+    double maxStretch = 0.25;   // tuyến dài tối đa (1 + maxStretch) * D
+    double maxSharing = 0.8;    // phần trùng với các tuyến đã chọn tối đa maxSharing * D
+    double minPlateau = 0.25;   // tối ưu cục bộ: plateau dài ít nhất minPlateau * D
+};
+
 class AlternativeRoute {
 public: 
     AlternativeRoute(RoadMap& map);
@@ -22,6 +32,22 @@ public:
     AlternativeRouteResult findAlternativeRoute(const std::string& blockedEdgeId,
                                                  const std::string& start,
                                                  const std::string& goal);
+
+    // k tuyến khác nhau tốt nhất (Yen, xem KShortestPaths), không chặn Edge nào trên
+    // bản đồ; tuyến đầu tiên là đường ngắn nhất. Rỗng nếu không có đường.
+    std::vector<AlternativeRouteResult> findTopRoutes(const std::string& start,
+                                                      const std::string& goal,
+                                                      size_t k);
+    // Tuyến thay thế theo node trung gian (via-node) và plateau: một cây đường ngắn
+    // nhất xuôi từ start và một cây ngược tới goal, mỗi cây dừng ở (1 + maxStretch) * D.
+    // Plateau là chuỗi Edge nằm trên cả hai cây; mọi node của một plateau cho cùng
+    // một tuyến via (start -> plateau -> goal). Tuyến được xếp theo
+    // 2 * độ dài + phần trùng - độ dài plateau (nhỏ hơn là tốt hơn) và chọn tham lam
+    // tới khi đủ maxAlternatives. Không gồm đường ngắn nhất; rỗng nếu không có tuyến đạt.
+    std::vector<AlternativeRouteResult> findViaAlternatives(const std::string& start,
+                                                            const std::string& goal,
+                                                            size_t maxAlternatives,
+                                                            const ViaRouteOptions& options = ViaRouteOptions());
 private:
     RoadMap& map_;
 };
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "ArcFlags.h"
+#include "ThreadPool.h"
+#include "SearchWorkspace.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+
+using namespace std;
+
+namespace {
+    const uint32_t MAX_REGIONS = 4096;
+    // Sai số tương đối khi nhận một cung là "chặt" (d(u) = w + d(v)): nhận dư chỉ làm
+    // bật thêm cờ, vẫn đúng
+    const double TIGHT_EPS = 1e-9;
+}
+
+/**
+ * @brief Chia nodes[first, last) cho count vùng bắt đầu từ firstRegion: cắt theo
+ *        chiều trải rộng hơn (kinh độ nhân cos vĩ độ), mỗi nửa nhận số node tỉ lệ
+ *        với số vùng của nó.
+ */
+void ArcFlags::partition(const CompactGraph& g, vector<uint32_t>& nodes, size_t first, size_t last,
+                         uint32_t firstRegion, uint32_t count) {
+    if (count <= 1 || last - first <= 1) {
+        for (size_t i = first; i < last; i++) region_[nodes[i]] = static_cast<uint16_t>(firstRegion);
+        return;
+    }
+
+    double minLat = 1e18, maxLat = -1e18, minLon = 1e18, maxLon = -1e18;
+    for (size_t i = first; i < last; i++) {
+        uint32_t v = nodes[i];
+        minLat = min(minLat, g.lat[v]);
+        maxLat = max(maxLat, g.lat[v]);
+        minLon = min(minLon, g.lon[v]);
+        maxLon = max(maxLon, g.lon[v]);
+    }
+    double lonScale = cos((minLat + maxLat) / 2 * M_PI / 180);
+    bool byLat = maxLat - minLat >= (maxLon - minLon) * lonScale;
+
+    uint32_t leftCount = count / 2;
+    size_t mid = first + (last - first) * leftCount / count;
+    nth_element(nodes.begin() + first, nodes.begin() + mid, nodes.begin() + last,
+                [&](uint32_t a, uint32_t b) { return byLat ? g.lat[a] < g.lat[b] : g.lon[a] < g.lon[b]; });
+
+    partition(g, nodes, first, mid, firstRegion, leftCount);
+    partition(g, nodes, mid, last, firstRegion + leftCount, count - leftCount);
+}
+
+/**
+ * @brief Cung trong cùng một vùng luôn có cờ của vùng đó. Với mỗi node biên b của
+ *        vùng r (có cung đi vào từ vùng khác), Dijkstra ngược từ b cho d(., b); cung
+ *        u -> v với d(u) = w + d(v) nằm trên một đường ngắn nhất tới b nên được bật
+ *        cờ r. Các node biên của một vùng chạy song song, đánh dấu vào mảng nguyên tử
+ *        rồi mới ghi vào bit của vùng.
+ */
+void ArcFlags::build(const CompactGraph& g, uint32_t regions, unsigned threads) {
+    const uint32_t n = g.numNodes();
+    const uint32_t m = g.numEdges();
+    regions = max(1u, min({regions, MAX_REGIONS, max(1u, n)}));
+    threads = defaultThreadCount(threads);
+
+    regions_ = regions;
+    words_ = (regions + 63) / 64;
+    region_.assign(n, 0);
+    flags_.assign(static_cast<size_t>(m) * words_, 0);
+
+    vector<uint32_t> nodes(n);
+    for (uint32_t v = 0; v < n; v++) nodes[v] = v;
+    partition(g, nodes, 0, n, 0, regions);
+
+    auto setFlag = [&](uint32_t e, uint32_t r) {
+        flags_[static_cast<size_t>(e) * words_ + r / 64] |= uint64_t(1) << (r % 64);
+    };
+
+    // Node biên của từng vùng; duyệt thẳng mảng CSR để bỏ qua trạng thái chặn
+    vector<vector<uint32_t>> boundary(regions);
+    for (uint32_t v = 0; v < n; v++) {
+        for (uint32_t i = g.firstIn[v]; i < g.firstIn[v + 1]; i++) {
+            if (region_[g.tail[g.inEdge[i]]] != region_[v]) {
+                boundary[region_[v]].push_back(v);
+                break;
+            }
+        }
+    }
+    for (uint32_t e = 0; e < m; e++)
+        if (region_[g.tail[e]] == region_[g.head[e]]) setFlag(e, region_[g.head[e]]);
+
+    unique_ptr<atomic<uint8_t>[]> onPath(new atomic<uint8_t>[m]);
+    for (uint32_t e = 0; e < m; e++) onPath[e].store(0, memory_order_relaxed);
+
+    unique_ptr<ThreadPool> pool;
+    if (threads > 1) pool.reset(new ThreadPool(threads - 1));
+    for (uint32_t r = 0; r < regions; r++) {
+        parallelFor(pool.get(), boundary[r].size(), [&](size_t i) {
+            uint32_t b = boundary[r][i];
+            SearchWorkspace& ws = SearchWorkspace::forThread();
+            ws.reset(n);
+            ws.set(b, 0, SearchWorkspace::NONE);
+            ws.push(0, b);
+            while (!ws.empty()) {
+                auto [d, v] = ws.pop();
+                if (d > ws.dist(v)) continue;
+                for (uint32_t k = g.firstIn[v]; k < g.firstIn[v + 1]; k++) {
+                    uint32_t e = g.inEdge[k];
+                    uint32_t u = g.tail[e];
+                    double nd = d + g.weight[e];
+                    if (nd < ws.dist(u)) {
+                        ws.set(u, nd, e);
+                        ws.push(nd, u);
+                    }
+                }
+            }
+            // d(u) đã chốt hết: đánh dấu mọi cung chặt
+            for (uint32_t e = 0; e < m; e++) {
+                uint32_t u = g.tail[e], v = g.head[e];
+                if (!ws.reached(v) || !ws.reached(u)) continue;
+                double via = ws.dist(v) + g.weight[e];
+                if (via <= ws.dist(u) * (1 + TIGHT_EPS)) onPath[e].store(1, memory_order_relaxed);
+            }
+        }, 1);
+
+        for (uint32_t e = 0; e < m; e++) {
+            if (onPath[e].load(memory_order_relaxed)) {
+                setFlag(e, r);
+                onPath[e].store(0, memory_order_relaxed);
+            }
+        }
+    }
+
+    version_ = g.version;
+    weightVersion_ = g.weightVersion;
+}
+
+double ArcFlags::density() const {
+    if (flags_.empty()) return 0;
+    size_t bits = 0;
+    for (uint64_t w : flags_) bits += static_cast<size_t>(__builtin_popcountll(w));
+    return static_cast<double>(bits) / (static_cast<double>(flags_.size() / words_) * regions_);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "CompactGraph.h"
+#include <cstdint>
+#include <vector>
+
+// Tiền xử lý arc flags cho tìm kiếm có hướng tới đích.
+// Bản đồ được chia thành k vùng bằng chia đôi đệ quy theo tọa độ node. Mỗi Edge
+// mang một dãy k bit nén: bit r bật nếu Edge nằm trên một đường ngắn nhất nào đó
+// đi vào vùng r. Truy vấn tới node thuộc vùng r chỉ cần đi trên các Edge có bit r.
+// Cờ được tính bằng Dijkstra ngược từ mọi node biên của từng vùng (song song), trên
+// đồ thị không chặn Edge nào. Chặn Edge có thể làm đường ngắn nhất mới đi qua Edge
+// không có cờ, nên khi bản đồ đang chặn Edge, ShortestPath không dùng cờ.
+class ArcFlags {
+public:
+    // regions: số vùng (1..4096); threads = 0: dùng std::thread::hardware_concurrency()
+    void build(const CompactGraph& g, uint32_t regions = 32, unsigned threads = 0);
+
+    // Mọi thay đổi weight (tăng hay giảm) đều có thể đổi đường ngắn nhất
+    bool isValidFor(const CompactGraph& g) const {
+        return regions_ > 0 && version_ == g.version && weightVersion_ == g.weightVersion;
+    }
+
+    uint32_t numRegions() const { return regions_; }
+    uint32_t region(uint32_t v) const { return region_[v]; }
+
+    // Edge có nằm trên đường ngắn nhất nào đó vào vùng r không
+    bool flag(uint32_t edge, uint32_t r) const {
+        return (flags_[static_cast<size_t>(edge) * words_ + r / 64] >> (r % 64)) & 1u;
+    }
+
+    // Tỉ lệ bit được bật trên tổng số bit (càng nhỏ càng tỉa được nhiều)
+    double density() const;
+
+private:
+    uint32_t regions_ = 0;
+    uint32_t words_ = 0;            // số từ 64 bit cho mỗi Edge
+    uint64_t version_ = 0;
+    uint64_t weightVersion_ = 0;
+    std::vector<uint16_t> region_;  // vùng của mỗi node
+    std::vector<uint64_t> flags_;   // [edge * words_ + r / 64], bit r % 64
+
+    void partition(const CompactGraph& g, std::vector<uint32_t>& nodes, size_t first, size_t last,
+                   uint32_t firstRegion, uint32_t count);
+};
@@ -0,0 +1,42 @@
+#include "BatchRouter.h"
+#include <algorithm>
+
+using namespace std;
+
+BatchRouter::BatchRouter(RoadMap& map, unsigned threads) : map_(map), pool_(threads) {}
+
+/**
+ * @brief Chia lô thành các khối QUERIES_PER_TASK truy vấn; mỗi khối ghi vào đúng
+ *        vị trí của nó trong kết quả nên không cần đồng bộ thêm.
+ */
+vector<RouteResult> BatchRouter::route(const vector<RouteQuery>& queries, bool withPaths) {
+    vector<RouteResult> results(queries.size());
+    if (queries.empty()) return results;
+
+    // dựng đồ thị (nếu cần) trên luồng gọi, trước khi các worker đọc nó
+    map_.graph();
+
+    for (size_t first = 0; first < queries.size(); first += QUERIES_PER_TASK) {
+        size_t last = min(queries.size(), first + QUERIES_PER_TASK);
+        pool_.submit([this, &queries, &results, first, last, withPaths] {
+            ShortestPath sp(map_);
+            sp.setAlgorithm(algorithm_);
+            sp.setLandmarks(landmarks_);
+            sp.setContractionHierarchy(ch_);
+            sp.setCustomizableCH(cch_);
+            sp.setHubLabels(hubLabels_);
+            sp.setArcFlags(arcFlags_);
+            sp.setMetric(metric_);
+            for (size_t i = first; i < last; i++) {
+                const RouteQuery& q = queries[i];
+                RouteResult& r = results[i];
+                sp.setClosures(q.closures);
+                r.time = withPaths ? sp.findShortestPath(q.start, q.goal, r.path)
+                                   : sp.travelTime(q.start, q.goal);
+                if (r.time < 0) r.path.clear();
+            }
+        });
+    }
+    pool_.wait();
+    return results;
+}
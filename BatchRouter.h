@@ -0,0 +1,57 @@
+#pragma once
+#include "ShortestPath.h"
+#include "ThreadPool.h"
+#include <string>
+#include <vector>
+
+struct RouteQuery {
+    std::string start;
+    std::string goal;
+    // Edge đóng riêng cho truy vấn này (không sở hữu, xem ShortestPath::setClosures):
+    // nhiều kịch bản đóng đường chạy song song trên cùng bản đồ
+    const ClosureSet* closures = nullptr;
+};
+
+struct RouteResult {
+    double time = -1;                   // -1 nếu không có đường hoặc ID không tồn tại
+    std::vector<std::string> path;      // rỗng nếu không có đường hoặc không yêu cầu đường đi
+};
+
+// Chạy hàng loạt truy vấn điểm - điểm trên thread pool đánh cắp việc.
+// Đồ thị được dựng một lần trước khi chia việc, sau đó các luồng chỉ đọc; mỗi
+// luồng dùng SearchWorkspace riêng. Kết quả trả về theo đúng thứ tự đầu vào.
+// Không được sửa bản đồ (blockEdge, setEdgeSpeed, addEdge, ...) khi route() đang chạy.
+class BatchRouter {
+public:
+    // threads = 0: dùng std::thread::hardware_concurrency()
+    BatchRouter(RoadMap& map, unsigned threads = 0);
+
+    // Cấu hình giống ShortestPath, áp dụng cho mọi truy vấn của lô
+    void setAlgorithm(RoutingAlgorithm algorithm) { algorithm_ = algorithm; }
+    void setLandmarks(const LandmarkIndex* landmarks) { landmarks_ = landmarks; }
+    void setContractionHierarchy(const ContractionHierarchy* ch) { ch_ = ch; }
+    void setCustomizableCH(const CustomizableCH* cch) { cch_ = cch; }
+    void setHubLabels(const HubLabels* labels) { hubLabels_ = labels; }
+    void setArcFlags(const ArcFlags* flags) { arcFlags_ = flags; }
+    void setMetric(MetricKind metric) { metric_ = metric; }
+    bool setMetric(const std::string& name) { return metricFromName(name, metric_); }
+
+    // withPaths = false: chỉ tính thời gian (dùng hub label nếu có)
+    std::vector<RouteResult> route(const std::vector<RouteQuery>& queries, bool withPaths = true);
+
+    unsigned threads() const { return pool_.size(); }
+
+private:
+    // Số truy vấn trong một việc gửi vào pool
+    static constexpr size_t QUERIES_PER_TASK = 32;
+
+    RoadMap& map_;
+    ThreadPool pool_;
+    RoutingAlgorithm algorithm_ = RoutingAlgorithm::DIJKSTRA;
+    const LandmarkIndex* landmarks_ = nullptr;
+    const ContractionHierarchy* ch_ = nullptr;
+    const CustomizableCH* cch_ = nullptr;
+    const HubLabels* hubLabels_ = nullptr;
+    const ArcFlags* arcFlags_ = nullptr;
+    MetricKind metric_ = MetricKind::TRAVEL_TIME;
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include "CompactGraph.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Tập Edge bị đóng chỉ trong phạm vi truy vấn: bitset theo chỉ số Edge của một
+// graph() cụ thể, dựng một lần rồi chỉ đọc. Khác RoadMap::blockEdge, tập này không
+// sửa bản đồ, nên nhiều kịch bản đóng đường có thể chạy song song trên cùng một
+// RoadMap (mỗi luồng một ShortestPath, xem ShortestPath::setClosures). Như blockEdge,
+// đóng Edge gốc của đường hai chiều thì đóng cả Edge ngược; đóng Edge "_rev" chỉ
+// đóng chiều đó.
+class ClosureSet {
+public:
+    ClosureSet() = default;
+
+    // Chỉ số Edge ngoài phạm vi bị bỏ qua
+    ClosureSet(const CompactGraph& g, const std::vector<uint32_t>& edges)
+        : bits_((g.numEdges() + 63) / 64, 0), version_(g.version) {
+        for (uint32_t e : edges) {
+            if (e >= g.numEdges()) continue;
+            add(e);
+            if (g.twin[e] != CompactGraph::INVALID) add(g.twin[e]);
+        }
+    }
+
+    // ID không tồn tại bị bỏ qua (kiểm tra bằng RoadMap::hasEdge nếu cần báo lỗi)
+    ClosureSet(const CompactGraph& g, const std::vector<std::string>& edgeIds)
+        : ClosureSet(g, toIndices(g, edgeIds)) {}
+
+    bool contains(uint32_t edge) const {
+        return edge / 64 < bits_.size() && ((bits_[edge / 64] >> (edge % 64)) & 1u);
+    }
+    bool empty() const { return count_ == 0; }
+    size_t size() const { return count_; }
+
+    // Chỉ số Edge chỉ có nghĩa với đúng lần dựng graph() đã dùng để tạo tập
+    bool isValidFor(const CompactGraph& g) const { return version_ == g.version; }
+
+private:
+    std::vector<uint64_t> bits_;
+    size_t count_ = 0;
+    uint64_t version_ = 0;
+
+    void add(uint32_t e) {
+        uint64_t bit = uint64_t(1) << (e % 64);
+        if (!(bits_[e / 64] & bit)) count_++;
+        bits_[e / 64] |= bit;
+    }
+
+    static std::vector<uint32_t> toIndices(const CompactGraph& g, const std::vector<std::string>& ids) {
+        std::vector<uint32_t> edges;
+        edges.reserve(ids.size());
+        for (const std::string& id : ids) edges.push_back(g.findEdge(id));
+        return edges;
+    }
+};
@@ -0,0 +1,176 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "TimeProfiles.h"
+
+template <bool Incoming> class BasicArcRange;
+using ArcRange = BasicArcRange<false>;
+using InArcRange = BasicArcRange<true>;
+
+// Chi phí rẽ từ Edge from sang Edge to tại node head[from] == tail[to]
+struct TurnEntry {
+    uint32_t from;
+    uint32_t to;
+    double cost;        // giờ; vô hạn = cấm rẽ
+};
+
+// Biểu diễn CSR (compressed sparse row) "đóng băng" của RoadMap.
+// Node được đánh số liên tục 0..n-1 theo thứ tự thêm vào bản đồ.
+// Edge được đánh số liên tục 0..m-1 theo thứ tự CSR: các cung đi ra từ node u
+// nằm liền nhau trong đoạn [firstOut[u], firstOut[u+1]). Chỉ số Edge chính là
+// chỉ số cung, nên mọi mảng thuộc tính theo Edge đều dùng chung chỉ số này.
+// Chuỗi ID chỉ dùng ở biên API (nodeIds/edgeIds và hai bảng tra ngược).
+struct CompactGraph {
+    static constexpr uint32_t INVALID = 0xFFFFFFFFu;
+    // weight của Edge có avgSpeed = 0 (xem Edge::travelTime()): vẫn đi được nhưng
+    // không dùng để ước lượng phân bố weight hay cấp phát theo khóa
+    static constexpr double NO_SPEED_WEIGHT = 1e9;
+
+    std::vector<uint32_t> firstOut;   // n + 1 phần tử
+    std::vector<uint32_t> head;       // node đích của cung
+    std::vector<uint32_t> tail;       // node nguồn của cung
+    std::vector<double> weight;       // Edge::travelTime() tại thời điểm đóng băng
+    std::vector<uint8_t> blocked;     // 1 nếu Edge đang bị chặn
+    // Edge chiều ngược của đường hai chiều, chỉ đặt ở Edge gốc (INVALID ở Edge "_rev"
+    // và Edge một chiều): chặn hay đổi tốc độ Edge gốc áp dụng cho cả hai chiều
+    std::vector<uint32_t> twin;
+
+    // Thuộc tính Edge cho các hàm chi phí khác thời gian (xem Metrics.h)
+    std::vector<double> length;
+    std::vector<double> budget;
+    std::vector<uint8_t> roadType;    // static_cast<uint8_t>(RoadType)
+    // Thời gian đi có tính ùn tắc (BPR theo flow/capacity), cập nhật từng Edge
+    // qua RoadMap::setEdgeFlow / setEdgeSpeed
+    std::vector<double> congestedWeight;
+
+    // Profile thời gian theo giờ trong ngày (rỗng nếu bản đồ không có profile)
+    TimeProfiles profiles;
+
+    // Bảng rẽ nhỏ theo node: các mục tại node v là turns[turnFirst[v] .. turnFirst[v+1]),
+    // sắp theo (from, to). Rỗng nếu bản đồ không có hạn chế rẽ.
+    std::vector<uint32_t> turnFirst;
+    std::vector<TurnEntry> turns;
+    double uTurnPenalty = 0;        // cộng khi quay đầu (to đi ngược về tail[from]) mà không có mục riêng
+
+    bool hasTurnCosts() const { return !turns.empty() || uTurnPenalty > 0; }
+
+    // Chi phí rẽ from -> to (from đi vào node mà to đi ra)
+    double turnCost(uint32_t from, uint32_t to) const {
+        if (!turns.empty()) {
+            uint32_t v = head[from];
+            for (uint32_t i = turnFirst[v]; i < turnFirst[v + 1]; i++)
+                if (turns[i].from == from && turns[i].to == to) return turns[i].cost;
+        }
+        return head[to] == tail[from] ? uTurnPenalty : 0;
+    }
+
+    // Chỉ mục ngược: các cung đi vào node v là inEdge[firstIn[v] .. firstIn[v+1])
+    std::vector<uint32_t> firstIn;    // n + 1 phần tử
+    std::vector<uint32_t> inEdge;     // chỉ số Edge, sắp theo node đích
+
+    // Tọa độ node (độ) cho các heuristic hình học
+    std::vector<double> lat;
+    std::vector<double> lon;
+
+    // Cận dưới thời gian đi 1 km đường chim bay, tính một lần khi dựng đồ thị:
+    // min trên mọi Edge của weight / haversine(src, dst). Bằng 1 / tốc độ lớn nhất
+    // khi mọi đoạn đường dài ít nhất bằng khoảng cách chim bay; nhỏ hơn nếu dữ liệu
+    // có đoạn ngắn hơn, để heuristic A* luôn chấp nhận được (admissible).
+    double minTimePerKm = 0;
+    double maxSpeed = 0;
+
+    // Số hiệu lần dựng, tăng mỗi lần RoadMap dựng lại đồ thị. Dữ liệu tiền xử lý
+    // (landmark, ...) ghi lại số này để biết chỉ số node/Edge còn khớp hay không.
+    uint64_t version = 0;
+    // Tăng mỗi khi weight của một Edge thay đổi (RoadMap::setEdgeSpeed)
+    uint64_t weightVersion = 0;
+    // Chỉ tăng khi có weight giảm: cận dưới tính trước đó không còn chắc đúng
+    uint64_t decreaseVersion = 0;
+
+    // Nhật ký Edge vừa đổi weight hoặc trạng thái chặn kể từ lần dựng (xem
+    // DynamicShortestPath): thay đổi thứ k là changeLog[k - changeLogStart]. Chỉ giữ
+    // các mục gần nhất; ai đọc chậm hơn changeLogStart thì phải tính lại từ đầu.
+    std::vector<uint32_t> changeLog;
+    uint64_t changeLogStart = 0;
+    uint64_t changeCount() const { return changeLogStart + changeLog.size(); }
+
+    std::vector<std::string> nodeIds;
+    std::vector<std::string> edgeIds;
+    std::unordered_map<std::string, uint32_t> nodeIndex;
+    std::unordered_map<std::string, uint32_t> edgeIndex;
+
+    uint32_t numNodes() const { return static_cast<uint32_t>(nodeIds.size()); }
+    uint32_t numEdges() const { return static_cast<uint32_t>(head.size()); }
+
+    // Trả về INVALID nếu không tồn tại
+    uint32_t findNode(const std::string& id) const {
+        auto it = nodeIndex.find(id);
+        return it == nodeIndex.end() ? INVALID : it->second;
+    }
+    uint32_t findEdge(const std::string& id) const {
+        auto it = edgeIndex.find(id);
+        return it == edgeIndex.end() ? INVALID : it->second;
+    }
+
+    // Duyệt các cung đi ra từ node u, bỏ qua Edge bị chặn, không cấp phát bộ nhớ
+    ArcRange outArcs(uint32_t u) const;
+    // Duyệt các cung đi vào node v; ArcView::target là node nguồn của cung
+    InArcRange inArcs(uint32_t v) const;
+};
+
+// Khung nhìn gọn nhẹ của một cung: không sao chép Edge hay chuỗi ID
+struct ArcView {
+    uint32_t target;
+    double weight;
+    uint32_t edge;
+};
+
+// Range không sở hữu dữ liệu trên đoạn CSR của một node.
+// Incoming = false: đoạn [firstOut[u], firstOut[u+1]) của mảng cung.
+// Incoming = true: đoạn [firstIn[v], firstIn[v+1]) của mảng inEdge.
+template <bool Incoming>
+class BasicArcRange {
+public:
+    class iterator {
+    public:
+        iterator(const CompactGraph* g, uint32_t a, uint32_t end)
+            : g_(g), a_(a), end_(end) { skipBlocked(); }
+
+        ArcView operator*() const {
+            uint32_t e = edge();
+            return {Incoming ? g_->tail[e] : g_->head[e], g_->weight[e], e};
+        }
+        iterator& operator++() { ++a_; skipBlocked(); return *this; }
+        bool operator!=(const iterator& o) const { return a_ != o.a_; }
+        bool operator==(const iterator& o) const { return a_ == o.a_; }
+
+    private:
+        uint32_t edge() const { return Incoming ? g_->inEdge[a_] : a_; }
+        void skipBlocked() { while (a_ < end_ && g_->blocked[edge()]) ++a_; }
+
+        const CompactGraph* g_;
+        uint32_t a_;
+        uint32_t end_;
+    };
+
+    BasicArcRange(const CompactGraph& g, uint32_t first, uint32_t last)
+        : g_(&g), first_(first), last_(last) {}
+
+    iterator begin() const { return iterator(g_, first_, last_); }
+    iterator end() const { return iterator(g_, last_, last_); }
+
+private:
+    const CompactGraph* g_;
+    uint32_t first_;
+    uint32_t last_;
+};
+
+inline ArcRange CompactGraph::outArcs(uint32_t u) const {
+    return ArcRange(*this, firstOut[u], firstOut[u + 1]);
+}
+
+inline InArcRange CompactGraph::inArcs(uint32_t v) const {
+    return InArcRange(*this, firstIn[v], firstIn[v + 1]);
+}
@@ -0,0 +1,326 @@
+#include "ContractionHierarchy.h"
+#include "SearchWorkspace.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+using namespace std;
+
+namespace {
+    const double INF = numeric_limits<double>::infinity();
+    const uint32_t NONE = CompactGraph::INVALID;
+
+    // Giới hạn số node được chốt trong một lần tìm đường chứng (witness search).
+    // Dừng sớm chỉ làm thừa cung tắt, không làm sai khoảng cách.
+    const uint32_t WITNESS_SETTLE_LIMIT = 500;
+
+    struct Adj {
+        uint32_t node;
+        double w;
+        uint32_t arc;
+    };
+
+    struct Shortcut {
+        uint32_t from;
+        uint32_t to;
+        double w;
+        uint32_t child1;
+        uint32_t child2;
+    };
+
+    // Đồ thị động trong lúc co: chỉ giữ cung giữa các node chưa bị co
+    struct DynamicGraph {
+        vector<vector<Adj>> out;
+        vector<vector<Adj>> in;
+        vector<uint8_t> removed;    // đã co, hoặc đang co trong vòng hiện tại
+
+        /**
+         * @brief Tính các cung tắt cần thêm khi co v. Đường chứng không đi qua v và
+         *        không đi qua node đã/đang bị co (removed), nên các node trong cùng
+         *        một tập độc lập có thể được co song song.
+         */
+        void shortcutsFor(uint32_t v, vector<Shortcut>& result) const {
+            result.clear();
+            SearchWorkspace& ws = SearchWorkspace::forThread();
+
+            for (const Adj& x : in[v]) {
+                // -1: không có cặp x -> v -> y nào (trọng số 0 vẫn là một cặp hợp lệ)
+                double maxW = -1;
+                for (const Adj& y : out[v])
+                    if (y.node != x.node) maxW = max(maxW, x.w + y.w);
+                if (maxW < 0) continue;
+
+                // Dijkstra giới hạn từ x, bỏ qua v
+                ws.reset(static_cast<uint32_t>(out.size()));
+                ws.set(x.node, 0, NONE);
+                ws.push(0, x.node);
+                uint32_t settled = 0;
+                while (!ws.empty()) {
+                    auto [d, u] = ws.pop();
+                    if (d > ws.dist(u)) continue;
+                    if (d > maxW || ++settled > WITNESS_SETTLE_LIMIT) break;
+                    for (const Adj& e : out[u]) {
+                        if (e.node == v || removed[e.node]) continue;
+                        double nd = d + e.w;
+                        if (nd < ws.dist(e.node)) {
+                            ws.set(e.node, nd, NONE);
+                            ws.push(nd, e.node);
+                        }
+                    }
+                }
+
+                for (const Adj& y : out[v]) {
+                    if (y.node == x.node) continue;
+                    double via = x.w + y.w;
+                    if (ws.dist(y.node) > via)
+                        result.push_back({x.node, y.node, via, x.arc, y.arc});
+                }
+            }
+        }
+    };
+}
+
+/**
+ * @brief Dựng phân cấp: mỗi vòng chọn tập độc lập các node có độ ưu tiên nhỏ nhất
+ *        trong lân cận, tính cung tắt song song cho cả tập, rồi áp dụng tuần tự.
+ *        Độ ưu tiên = 2 * (số cung tắt - số cung bị xóa) + số láng giềng đã co
+ *        + độ sâu trong phân cấp.
+ */
+void ContractionHierarchy::build(const CompactGraph& g, unsigned threads) {
+    const uint32_t n = g.numNodes();
+    threads = defaultThreadCount(threads);
+    // Luồng gọi làm cùng các worker; pool sống suốt quá trình co
+    unique_ptr<ThreadPool> pool;
+    if (threads > 1) pool.reset(new ThreadPool(threads - 1));
+
+    arcs_.clear();
+    rank_.assign(n, NONE);
+    numShortcuts_ = 0;
+
+    DynamicGraph dg;
+    dg.out.assign(n, {});
+    dg.in.assign(n, {});
+    dg.removed.assign(n, 0);
+
+    // Cung gốc: bỏ vòng tự thân, gộp cung song song giữ trọng số nhỏ nhất
+    for (uint32_t a = 0; a < g.numEdges(); a++) {
+        uint32_t u = g.tail[a], v = g.head[a];
+        if (u == v) continue;
+        auto it = find_if(dg.out[u].begin(), dg.out[u].end(),
+                          [&](const Adj& e) { return e.node == v; });
+        if (it != dg.out[u].end()) {
+            if (g.weight[a] < it->w) {
+                it->w = g.weight[a];
+                arcs_[it->arc].edge = a;
+                for (Adj& e : dg.in[v]) if (e.node == u) e.w = g.weight[a];
+            }
+            continue;
+        }
+        uint32_t id = static_cast<uint32_t>(arcs_.size());
+        arcs_.push_back({u, v, a, NONE, NONE});
+        dg.out[u].push_back({v, g.weight[a], id});
+        dg.in[v].push_back({u, g.weight[a], id});
+    }
+
+    vector<double> priority(n, 0);
+    vector<uint32_t> deletedNeighbors(n, 0);
+    vector<uint32_t> level(n, 0);
+    auto computePriority = [&](uint32_t v) {
+        vector<Shortcut> sc;
+        dg.shortcutsFor(v, sc);
+        priority[v] = 2.0 * (static_cast<double>(sc.size())
+                    - static_cast<double>(dg.in[v].size() + dg.out[v].size()))
+                    + deletedNeighbors[v] + level[v];
+    };
+    parallelFor(pool.get(), n, [&](size_t v) { computePriority(static_cast<uint32_t>(v)); });
+
+    // So sánh (độ ưu tiên, băm chỉ số) để phá thế hòa một cách ổn định
+    auto before = [&](uint32_t a, uint32_t b) {
+        if (priority[a] != priority[b]) return priority[a] < priority[b];
+        uint32_t ha = a * 2654435761u, hb = b * 2654435761u;
+        return ha != hb ? ha < hb : a < b;
+    };
+
+    vector<uint32_t> remaining(n);
+    for (uint32_t v = 0; v < n; v++) remaining[v] = v;
+    vector<vector<CHArc>> up(n), down(n);
+    uint32_t nextRank = 0;
+
+    vector<uint32_t> independent;
+    vector<vector<Shortcut>> shortcuts;
+    vector<uint32_t> touched;
+    vector<uint8_t> isTouched(n, 0);
+
+    while (!remaining.empty()) {
+        // 1. Tập độc lập: node đứng trước mọi láng giềng còn lại
+        independent.clear();
+        for (uint32_t v : remaining) {
+            bool local = true;
+            for (const Adj& e : dg.out[v]) if (!before(v, e.node)) { local = false; break; }
+            if (local)
+                for (const Adj& e : dg.in[v]) if (!before(v, e.node)) { local = false; break; }
+            if (local) independent.push_back(v);
+        }
+        for (uint32_t v : independent) dg.removed[v] = 1;
+
+        // 2. Tính cung tắt song song
+        shortcuts.resize(independent.size());
+        parallelFor(pool.get(), independent.size(), [&](size_t i) {
+            dg.shortcutsFor(independent[i], shortcuts[i]);
+        });
+
+        // 3. Áp dụng tuần tự
+        touched.clear();
+        for (size_t i = 0; i < independent.size(); i++) {
+            uint32_t v = independent[i];
+            rank_[v] = nextRank++;
+
+            for (const Adj& e : dg.out[v]) {
+                up[v].push_back({e.node, e.w, e.arc});
+                level[e.node] = max(level[e.node], level[v] + 1);
+                if (!isTouched[e.node]) { isTouched[e.node] = 1; touched.push_back(e.node); }
+            }
+            for (const Adj& e : dg.in[v]) {
+                down[v].push_back({e.node, e.w, e.arc});
+                level[e.node] = max(level[e.node], level[v] + 1);
+                if (!isTouched[e.node]) { isTouched[e.node] = 1; touched.push_back(e.node); }
+            }
+            dg.out[v].clear();
+            dg.in[v].clear();
+
+            for (const Shortcut& s : shortcuts[i]) {
+                auto it = find_if(dg.out[s.from].begin(), dg.out[s.from].end(),
+                                  [&](const Adj& e) { return e.node == s.to; });
+                if (it != dg.out[s.from].end()) {
+                    if (s.w >= it->w) continue;
+                    // cung đã có nhưng dài hơn: thay bằng cung tắt mới
+                    it->w = s.w;
+                    arcs_[it->arc] = {s.from, s.to, NONE, s.child1, s.child2};
+                    for (Adj& e : dg.in[s.to]) if (e.node == s.from) e.w = s.w;
+                    continue;
+                }
+                uint32_t id = static_cast<uint32_t>(arcs_.size());
+                arcs_.push_back({s.from, s.to, NONE, s.child1, s.child2});
+                dg.out[s.from].push_back({s.to, s.w, id});
+                dg.in[s.to].push_back({s.from, s.w, id});
+                numShortcuts_++;
+            }
+        }
+        // Xóa cung tới các node vừa co: mỗi danh sách kề chỉ lọc một lần mỗi vòng
+        auto isRemoved = [&](const Adj& x) { return dg.removed[x.node] != 0; };
+        for (uint32_t v : touched) {
+            dg.out[v].erase(remove_if(dg.out[v].begin(), dg.out[v].end(), isRemoved), dg.out[v].end());
+            dg.in[v].erase(remove_if(dg.in[v].begin(), dg.in[v].end(), isRemoved), dg.in[v].end());
+            deletedNeighbors[v]++;
+            isTouched[v] = 0;
+        }
+
+        // 4. Cập nhật độ ưu tiên của láng giềng, loại node đã co
+        parallelFor(pool.get(), touched.size(), [&](size_t i) { computePriority(touched[i]); });
+        remaining.erase(remove_if(remaining.begin(), remaining.end(),
+                                  [&](uint32_t v) { return dg.removed[v] != 0; }),
+                        remaining.end());
+    }
+
+    // Gom up/down thành CSR theo node
+    upFirst_.assign(n + 1, 0);
+    downFirst_.assign(n + 1, 0);
+    for (uint32_t v = 0; v < n; v++) {
+        upFirst_[v + 1] = upFirst_[v] + static_cast<uint32_t>(up[v].size());
+        downFirst_[v + 1] = downFirst_[v] + static_cast<uint32_t>(down[v].size());
+    }
+    upArcs_.clear();
+    downArcs_.clear();
+    upArcs_.reserve(upFirst_[n]);
+    downArcs_.reserve(downFirst_[n]);
+    for (uint32_t v = 0; v < n; v++) {
+        upArcs_.insert(upArcs_.end(), up[v].begin(), up[v].end());
+        downArcs_.insert(downArcs_.end(), down[v].begin(), down[v].end());
+    }
+
+    version_ = g.version;
+    weightVersion_ = g.weightVersion;
+    built_ = true;
+}
+
+/**
+ * @brief Truy vấn hai chiều chỉ đi lên: xuôi từ source theo upArcs, ngược từ target
+ *        theo downArcs. Mỗi phía dừng khi khóa nhỏ nhất của nó không nhỏ hơn mu.
+ */
+double ContractionHierarchy::query(uint32_t source, uint32_t target,
+                                   vector<uint32_t>& outEdges) const {
+    outEdges.clear();
+    const uint32_t n = numNodes();
+    if (!built_ || source >= n || target >= n) return -1;
+    if (source == target) return 0;
+
+    SearchWorkspace& fw = SearchWorkspace::forThread(0);
+    SearchWorkspace& bw = SearchWorkspace::forThread(1);
+    fw.reset(n);
+    bw.reset(n);
+    fw.set(source, 0, NONE);
+    bw.set(target, 0, NONE);
+    fw.push(0, source);
+    bw.push(0, target);
+
+    double mu = INF;
+    uint32_t meet = NONE;
+
+    while (true) {
+        bool fwActive = !fw.empty() && fw.topKey() < mu;
+        bool bwActive = !bw.empty() && bw.topKey() < mu;
+        if (!fwActive && !bwActive) break;
+
+        bool forward = fwActive && (!bwActive || fw.topKey() <= bw.topKey());
+        SearchWorkspace& ws = forward ? fw : bw;
+        SearchWorkspace& other = forward ? bw : fw;
+
+        auto [d, u] = ws.pop();
+        if (d > ws.dist(u)) continue;
+
+        if (other.reached(u) && d + other.dist(u) < mu) {
+            mu = d + other.dist(u);
+            meet = u;
+        }
+
+        for (const CHArc& arc : forward ? upArcs(u) : downArcs(u)) {
+            double nd = d + arc.weight;
+            if (nd < ws.dist(arc.node)) {
+                ws.set(arc.node, nd, arc.id);
+                ws.push(nd, arc.node);
+            }
+        }
+    }
+
+    if (meet == NONE) return -1;
+
+    // Dãy cung phân cấp: source -> meet rồi meet -> target
+    vector<uint32_t> chArcs;
+    for (uint32_t cur = meet; cur != source; cur = arcs_[fw.parent(cur)].from)
+        chArcs.push_back(fw.parent(cur));
+    reverse(chArcs.begin(), chArcs.end());
+    for (uint32_t cur = meet; cur != target; cur = arcs_[bw.parent(cur)].to)
+        chArcs.push_back(bw.parent(cur));
+
+    for (uint32_t id : chArcs) unpackArc(id, outEdges);
+    return mu;
+}
+
+/**
+ * @brief Bung cung tắt theo thứ tự từ trái sang phải bằng ngăn xếp.
+ */
+void ContractionHierarchy::unpackArc(uint32_t arcId, vector<uint32_t>& out) const {
+    vector<uint32_t> stack{arcId};
+    while (!stack.empty()) {
+        uint32_t id = stack.back();
+        stack.pop_back();
+        const ArcInfo& a = arcs_[id];
+        if (a.edge != NONE) {
+            out.push_back(a.edge);
+        } else {
+            stack.push_back(a.child2);
+            stack.push_back(a.child1);
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "CompactGraph.h"
+#include <cstdint>
+#include <vector>
+
+// Cung trong đồ thị phân cấp: nối tới node có thứ hạng cao hơn
+struct CHArc {
+    uint32_t node;      // node đầu kia (thứ hạng cao hơn)
+    double weight;
+    uint32_t id;        // chỉ số trong bảng cung của ContractionHierarchy
+};
+
+struct CHArcSpan {
+    const CHArc* first;
+    const CHArc* last;
+    const CHArc* begin() const { return first; }
+    const CHArc* end() const { return last; }
+};
+
+// Contraction Hierarchies: co node theo độ quan trọng, thêm cung tắt (shortcut)
+// để giữ nguyên khoảng cách. Truy vấn là Dijkstra hai chiều chỉ đi "lên" theo
+// thứ hạng; đường đi được bung các cung tắt về dãy Edge gốc của RoadMap.
+// Đồ thị được dựng với trọng số tại thời điểm build và bỏ qua trạng thái chặn.
+class ContractionHierarchy {
+public:
+    // threads = 0: dùng std::thread::hardware_concurrency()
+    void build(const CompactGraph& g, unsigned threads = 0);
+
+    bool isValidFor(const CompactGraph& g) const {
+        return built_ && version_ == g.version && weightVersion_ == g.weightVersion;
+    }
+
+    // Trả về -1 nếu không có đường; outEdges là dãy chỉ số Edge gốc
+    double query(uint32_t source, uint32_t target, std::vector<uint32_t>& outEdges) const;
+
+    uint32_t numNodes() const { return static_cast<uint32_t>(rank_.size()); }
+    uint32_t rank(uint32_t v) const { return rank_[v]; }
+    size_t numShortcuts() const { return numShortcuts_; }
+
+    // Cung v -> node với rank(node) > rank(v)
+    CHArcSpan upArcs(uint32_t v) const {
+        return {upArcs_.data() + upFirst_[v], upArcs_.data() + upFirst_[v + 1]};
+    }
+    // Cung node -> v với rank(node) > rank(v)
+    CHArcSpan downArcs(uint32_t v) const {
+        return {downArcs_.data() + downFirst_[v], downArcs_.data() + downFirst_[v + 1]};
+    }
+
+    // Bung một cung (có thể là cung tắt) thành dãy Edge gốc, nối vào out
+    void unpackArc(uint32_t arcId, std::vector<uint32_t>& out) const;
+
+private:
+    struct ArcInfo {
+        uint32_t from;
+        uint32_t to;
+        uint32_t edge;      // Edge gốc, hoặc INVALID nếu là cung tắt
+        uint32_t child1;    // from -> mid
+        uint32_t child2;    // mid -> to
+    };
+
+    bool built_ = false;
+    uint64_t version_ = 0;
+    uint64_t weightVersion_ = 0;
+    size_t numShortcuts_ = 0;
+
+    std::vector<uint32_t> rank_;
+    std::vector<ArcInfo> arcs_;
+    std::vector<uint32_t> upFirst_;
+    std::vector<CHArc> upArcs_;
+    std::vector<uint32_t> downFirst_;
+    std::vector<CHArc> downArcs_;
+};
@@ -0,0 +1,347 @@
+#include "CustomizableCH.h"
+#include "SearchWorkspace.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+namespace {
+    const double INF = numeric_limits<double>::infinity();
+
+    // Phần đồ thị nhỏ hơn ngưỡng này không chia tiếp
+    const size_t DISSECTION_LEAF_SIZE = 16;
+
+    struct Dissection {
+        const CompactGraph& g;
+        const vector<vector<uint32_t>>& nbr;
+        vector<uint8_t> side;       // 0 = ngoài tập đang xét, 1 = nửa A, 2 = nửa B
+        vector<uint32_t>& order;
+
+        /**
+         * @brief Chia đôi tập node theo trung vị của trục tọa độ trải rộng hơn; lấy
+         *        các node ở nửa nhỏ hơn có cạnh sang nửa kia làm tập tách. Sắp thứ tự:
+         *        nửa A, nửa B, rồi tập tách (hạng cao nhất).
+         */
+        void run(vector<uint32_t> nodes) {
+            if (nodes.size() <= DISSECTION_LEAF_SIZE) {
+                order.insert(order.end(), nodes.begin(), nodes.end());
+                return;
+            }
+
+            double minLat = INF, maxLat = -INF, minLon = INF, maxLon = -INF;
+            for (uint32_t v : nodes) {
+                minLat = min(minLat, g.lat[v]); maxLat = max(maxLat, g.lat[v]);
+                minLon = min(minLon, g.lon[v]); maxLon = max(maxLon, g.lon[v]);
+            }
+            const vector<double>& key = (maxLat - minLat >= maxLon - minLon) ? g.lat : g.lon;
+            auto mid = nodes.begin() + nodes.size() / 2;
+            nth_element(nodes.begin(), mid, nodes.end(), [&](uint32_t a, uint32_t b) {
+                return key[a] != key[b] ? key[a] < key[b] : a < b;
+            });
+
+            for (auto it = nodes.begin(); it != nodes.end(); ++it) side[*it] = it < mid ? 1 : 2;
+
+            vector<uint32_t> sepA, sepB;
+            for (uint32_t v : nodes) {
+                uint8_t other = side[v] == 1 ? 2 : 1;
+                for (uint32_t u : nbr[v]) {
+                    if (side[u] == other) {
+                        (side[v] == 1 ? sepA : sepB).push_back(v);
+                        break;
+                    }
+                }
+            }
+            const vector<uint32_t>& sep = sepA.size() <= sepB.size() ? sepA : sepB;
+
+            vector<uint32_t> partA, partB;
+            for (uint32_t v : sep) side[v] = 3;
+            for (uint32_t v : nodes) {
+                if (side[v] == 1) partA.push_back(v);
+                else if (side[v] == 2) partB.push_back(v);
+            }
+            for (uint32_t v : nodes) side[v] = 0;
+
+            vector<uint32_t> separator = sep;
+            nodes.clear();
+            nodes.shrink_to_fit();
+            run(std::move(partA));
+            run(std::move(partB));
+            order.insert(order.end(), separator.begin(), separator.end());
+        }
+    };
+}
+
+/**
+ * @brief Giai đoạn không phụ thuộc trọng số: thứ tự nested dissection, bù cạnh
+ *        theo thứ tự khử (cây khử), dựng danh sách cung lên/xuống và tầng.
+ */
+void CustomizableCH::build(const CompactGraph& g, unsigned threads) {
+    const uint32_t n = g.numNodes();
+    threads_ = defaultThreadCount(threads);
+    pool_.reset(threads_ > 1 ? new ThreadPool(threads_ - 1) : nullptr);
+
+    // Đồ thị vô hướng đơn
+    vector<vector<uint32_t>> nbr(n);
+    for (uint32_t a = 0; a < g.numEdges(); a++) {
+        uint32_t u = g.tail[a], v = g.head[a];
+        if (u == v) continue;
+        nbr[u].push_back(v);
+        nbr[v].push_back(u);
+    }
+    for (auto& l : nbr) {
+        sort(l.begin(), l.end());
+        l.erase(unique(l.begin(), l.end()), l.end());
+    }
+
+    // 1. Thứ tự co
+    vector<uint32_t> order;
+    order.reserve(n);
+    vector<uint32_t> all(n);
+    for (uint32_t v = 0; v < n; v++) all[v] = v;
+    Dissection nd{g, nbr, vector<uint8_t>(n, 0), order};
+    nd.run(std::move(all));
+
+    rank_.assign(n, NONE);
+    for (uint32_t i = 0; i < n; i++) rank_[order[i]] = i;
+    auto byRank = [&](uint32_t a, uint32_t b) { return rank_[a] < rank_[b]; };
+
+    // 2. Khử theo thứ tự hạng: láng giềng hạng cao của v (trừ cha) được nối vào cha
+    vector<vector<uint32_t>> up(n);
+    for (uint32_t v = 0; v < n; v++) {
+        for (uint32_t u : nbr[v]) if (rank_[u] > rank_[v]) up[v].push_back(u);
+        sort(up[v].begin(), up[v].end(), byRank);
+    }
+    nbr.clear();
+    parent_.assign(n, NONE);
+    vector<uint32_t> merged;
+    for (uint32_t v : order) {
+        if (up[v].empty()) continue;
+        uint32_t p = up[v][0];
+        parent_[v] = p;
+        merged.clear();
+        set_union(up[p].begin(), up[p].end(), up[v].begin() + 1, up[v].end(),
+                  back_inserter(merged), byRank);
+        up[p].swap(merged);
+    }
+
+    // 3. CSR cung hướng lên
+    upFirst_.assign(n + 1, 0);
+    for (uint32_t v = 0; v < n; v++)
+        upFirst_[v + 1] = upFirst_[v] + static_cast<uint32_t>(up[v].size());
+    arcTail_.resize(upFirst_[n]);
+    arcHead_.resize(upFirst_[n]);
+    for (uint32_t v = 0; v < n; v++) {
+        for (size_t i = 0; i < up[v].size(); i++) {
+            arcTail_[upFirst_[v] + i] = v;
+            arcHead_[upFirst_[v] + i] = up[v][i];
+        }
+    }
+    up.clear();
+
+    // 4. Danh sách kề hướng xuống, sắp theo hạng node thấp
+    downFirst_.assign(n + 1, 0);
+    for (uint32_t x = 0; x < arcHead_.size(); x++) downFirst_[arcHead_[x] + 1]++;
+    for (uint32_t v = 0; v < n; v++) downFirst_[v + 1] += downFirst_[v];
+    downNode_.resize(arcHead_.size());
+    downArc_.resize(arcHead_.size());
+    vector<uint32_t> pos(downFirst_.begin(), downFirst_.end() - 1);
+    for (uint32_t v : order) {      // duyệt theo hạng tăng dần nên mỗi danh sách đã sắp sẵn
+        for (uint32_t x = upFirst_[v]; x < upFirst_[v + 1]; x++) {
+            uint32_t p = pos[arcHead_[x]]++;
+            downNode_[p] = v;
+            downArc_[p] = x;
+        }
+    }
+
+    // 5. Tầng: 0 cho node không có láng giềng thấp hơn
+    vector<uint32_t> level(n, 0);
+    uint32_t maxLevel = 0;
+    for (uint32_t v : order) {
+        for (uint32_t i = downFirst_[v]; i < downFirst_[v + 1]; i++)
+            level[v] = max(level[v], level[downNode_[i]] + 1);
+        maxLevel = max(maxLevel, level[v]);
+    }
+    levelFirst_.assign(maxLevel + 2, 0);
+    for (uint32_t v = 0; v < n; v++) levelFirst_[level[v] + 1]++;
+    for (uint32_t l = 0; l <= maxLevel; l++) levelFirst_[l + 1] += levelFirst_[l];
+    levelNodes_.resize(n);
+    pos.assign(levelFirst_.begin(), levelFirst_.end() - 1);
+    for (uint32_t v = 0; v < n; v++) levelNodes_[pos[level[v]]++] = v;
+
+    // 6. Ánh xạ Edge gốc vào cung
+    inputArc_.assign(g.numEdges(), NONE);
+    inputUp_.assign(g.numEdges(), 0);
+    for (uint32_t a = 0; a < g.numEdges(); a++) {
+        uint32_t u = g.tail[a], v = g.head[a];
+        if (u == v) continue;
+        if (rank_[u] < rank_[v]) {
+            inputArc_[a] = findArc(u, v);
+            inputUp_[a] = 1;
+        } else {
+            inputArc_[a] = findArc(v, u);
+        }
+    }
+
+    metric_.reset();
+    version_ = g.version;
+    built_ = true;
+}
+
+/**
+ * @brief Tìm cung lower -> higher bằng tìm kiếm nhị phân theo hạng.
+ */
+uint32_t CustomizableCH::findArc(uint32_t lower, uint32_t higher) const {
+    auto first = arcHead_.begin() + upFirst_[lower];
+    auto last = arcHead_.begin() + upFirst_[lower + 1];
+    auto it = lower_bound(first, last, higher, [&](uint32_t a, uint32_t b) {
+        return rank_[a] < rank_[b];
+    });
+    return (it != last && *it == higher) ? static_cast<uint32_t>(it - arcHead_.begin()) : NONE;
+}
+
+/**
+ * @brief Customize cơ bản: nạp weight Edge gốc (Edge bị chặn = vô hạn), rồi với
+ *        mỗi cung (u, w) lấy min qua mọi tam giác dưới v < u, w:
+ *        up(u->w) = down(v,u) + up(v,w), down(w->u) = down(v,w) + up(v,u).
+ *        Cung của u chỉ phụ thuộc cung của các node ở tầng thấp hơn, nên các node
+ *        cùng tầng được xử lý song song.
+ */
+void CustomizableCH::customize(const CompactGraph& g) {
+    if (!isValidFor(g)) return;
+
+    const size_t m = arcHead_.size();
+    auto metric = make_shared<Metric>();
+    metric->up.assign(m, INF);
+    metric->down.assign(m, INF);
+    metric->upMid.assign(m, NONE);
+    metric->downMid.assign(m, NONE);
+    metric->upEdge.assign(m, NONE);
+    metric->downEdge.assign(m, NONE);
+    Metric& mt = *metric;
+
+    for (uint32_t a = 0; a < g.numEdges(); a++) {
+        uint32_t x = inputArc_[a];
+        if (x == NONE || g.blocked[a]) continue;
+        double w = g.weight[a];
+        if (inputUp_[a]) {
+            if (w < mt.up[x]) { mt.up[x] = w; mt.upEdge[x] = a; }
+        } else {
+            if (w < mt.down[x]) { mt.down[x] = w; mt.downEdge[x] = a; }
+        }
+    }
+
+    for (size_t l = 0; l + 1 < levelFirst_.size(); l++) {
+        size_t first = levelFirst_[l];
+        parallelFor(pool_.get(), levelFirst_[l + 1] - first, [&](size_t i) {
+            uint32_t u = levelNodes_[first + i];
+            for (uint32_t x = upFirst_[u]; x < upFirst_[u + 1]; x++) {
+                uint32_t w = arcHead_[x];
+                // giao hai danh sách xuống của u và w (cùng sắp theo hạng)
+                uint32_t i1 = downFirst_[u], e1 = downFirst_[u + 1];
+                uint32_t i2 = downFirst_[w], e2 = downFirst_[w + 1];
+                while (i1 < e1 && i2 < e2) {
+                    uint32_t v1 = downNode_[i1], v2 = downNode_[i2];
+                    if (rank_[v1] < rank_[v2]) { i1++; continue; }
+                    if (rank_[v2] < rank_[v1]) { i2++; continue; }
+                    uint32_t vu = downArc_[i1], vw = downArc_[i2];
+                    double c = mt.down[vu] + mt.up[vw];
+                    if (c < mt.up[x]) { mt.up[x] = c; mt.upMid[x] = v1; }
+                    c = mt.down[vw] + mt.up[vu];
+                    if (c < mt.down[x]) { mt.down[x] = c; mt.downMid[x] = v1; }
+                    i1++;
+                    i2++;
+                }
+            }
+        }, 16);
+    }
+
+    std::atomic_store(&metric_, std::shared_ptr<const Metric>(metric));
+}
+
+std::shared_ptr<const CustomizableCH::Metric> CustomizableCH::currentMetric() const {
+    return std::atomic_load(&metric_);
+}
+
+/**
+ * @brief Truy vấn theo cây khử: mọi node tới được bằng cung hướng lên từ s đều là
+ *        tổ tiên của s, nên chỉ cần quét đường từ s lên gốc theo thứ tự hạng tăng
+ *        (không cần hàng đợi ưu tiên). Làm tương tự cho t với trọng số down, rồi lấy
+ *        min df + db trên các tổ tiên chung.
+ */
+double CustomizableCH::query(uint32_t source, uint32_t target,
+                             vector<uint32_t>& outEdges) const {
+    outEdges.clear();
+    auto metric = currentMetric();
+    const uint32_t n = numNodes();
+    if (!metric || source >= n || target >= n) return -1;
+    const Metric& mt = *metric;
+
+    SearchWorkspace& fw = SearchWorkspace::forThread(0);
+    SearchWorkspace& bw = SearchWorkspace::forThread(1);
+    fw.reset(n);
+    bw.reset(n);
+    fw.set(source, 0, NONE);
+    bw.set(target, 0, NONE);
+
+    for (uint32_t v = source; v != NONE; v = parent_[v]) {
+        if (!fw.reached(v)) continue;
+        double d = fw.dist(v);
+        for (uint32_t x = upFirst_[v]; x < upFirst_[v + 1]; x++) {
+            double nd = d + mt.up[x];
+            if (nd < fw.dist(arcHead_[x])) fw.set(arcHead_[x], nd, x);
+        }
+    }
+    double mu = INF;
+    uint32_t meet = NONE;
+    for (uint32_t v = target; v != NONE; v = parent_[v]) {
+        if (!bw.reached(v)) continue;
+        double d = bw.dist(v);
+        if (fw.reached(v) && fw.dist(v) + d < mu) {
+            mu = fw.dist(v) + d;
+            meet = v;
+        }
+        for (uint32_t x = upFirst_[v]; x < upFirst_[v + 1]; x++) {
+            double nd = d + mt.down[x];
+            if (nd < bw.dist(arcHead_[x])) bw.set(arcHead_[x], nd, x);
+        }
+    }
+
+    if (meet == NONE || mu == INF) return -1;
+
+    vector<uint32_t> upPath;
+    for (uint32_t cur = meet; cur != source; cur = arcTail_[fw.parent(cur)])
+        upPath.push_back(fw.parent(cur));
+    for (auto it = upPath.rbegin(); it != upPath.rend(); ++it) unpack(mt, *it, true, outEdges);
+    for (uint32_t cur = meet; cur != target; cur = arcTail_[bw.parent(cur)])
+        unpack(mt, bw.parent(cur), false, outEdges);
+
+    return mu;
+}
+
+/**
+ * @brief Bung cung theo node giữa của tam giác đã ghi khi customize.
+ *        up (u->w qua v): down(v,u) rồi up(v,w); down (w->u qua v): down(v,w) rồi up(v,u).
+ */
+void CustomizableCH::unpack(const Metric& mt, uint32_t arc, bool up,
+                            vector<uint32_t>& out) const {
+    vector<pair<uint32_t, bool>> stack{{arc, up}};
+    while (!stack.empty()) {
+        auto [x, isUp] = stack.back();
+        stack.pop_back();
+        uint32_t mid = isUp ? mt.upMid[x] : mt.downMid[x];
+        if (mid == NONE) {
+            out.push_back(isUp ? mt.upEdge[x] : mt.downEdge[x]);
+            continue;
+        }
+        uint32_t vu = findArc(mid, arcTail_[x]);
+        uint32_t vw = findArc(mid, arcHead_[x]);
+        if (isUp) {
+            stack.push_back({vw, true});
+            stack.push_back({vu, false});
+        } else {
+            stack.push_back({vu, true});
+            stack.push_back({vw, false});
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include "CompactGraph.h"
+#include "ThreadPool.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Customizable Contraction Hierarchies (CCH).
+// Giai đoạn 1 (build, không phụ thuộc trọng số): thứ tự co theo chia đôi lồng nhau
+// (nested dissection) dựa trên tọa độ node, rồi bù cạnh (fill-in) để được đồ thị
+// hợp âm vô hướng; mỗi cung nối node hạng thấp với node hạng cao hơn.
+// Giai đoạn 2 (customize, chạy lại mỗi khi weight thay đổi): tính trọng số hai
+// chiều của mọi cung từ dưới lên, song song theo tầng của cây khử. Edge bị chặn
+// được coi là có weight vô hạn. Bộ trọng số mới được dựng riêng rồi mới tráo vào,
+// nên truy vấn đang chạy vẫn dùng bộ cũ và không phải dừng phục vụ.
+class CustomizableCH {
+public:
+    // threads = 0: dùng std::thread::hardware_concurrency()
+    void build(const CompactGraph& g, unsigned threads = 0);
+
+    // Tính lại trọng số từ g.weight / g.blocked hiện tại
+    void customize(const CompactGraph& g);
+
+    // Cấu trúc còn khớp với graph() (weight có thể đã đổi từ lần customize trước)
+    bool isValidFor(const CompactGraph& g) const { return built_ && version_ == g.version; }
+    bool isCustomized() const { return currentMetric() != nullptr; }
+
+    // Truy vấn trên bộ trọng số đã customize gần nhất; -1 nếu không có đường
+    double query(uint32_t source, uint32_t target, std::vector<uint32_t>& outEdges) const;
+
+    uint32_t numNodes() const { return static_cast<uint32_t>(rank_.size()); }
+    uint32_t rank(uint32_t v) const { return rank_[v]; }
+    size_t numArcs() const { return arcHead_.size(); }
+
+private:
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+    // Trọng số một chiều của các cung: up = thấp -> cao, down = cao -> thấp
+    struct Metric {
+        std::vector<double> up;
+        std::vector<double> down;
+        // Node giữa của tam giác tạo ra trọng số, hoặc NONE nếu lấy từ Edge gốc
+        std::vector<uint32_t> upMid;
+        std::vector<uint32_t> downMid;
+        // Edge gốc khi *Mid = NONE
+        std::vector<uint32_t> upEdge;
+        std::vector<uint32_t> downEdge;
+    };
+
+    bool built_ = false;
+    uint64_t version_ = 0;
+    unsigned threads_ = 1;
+    // Worker cho customize(), dựng một lần ở build() (luồng gọi làm cùng)
+    std::unique_ptr<ThreadPool> pool_;
+
+    std::vector<uint32_t> rank_;
+    std::vector<uint32_t> parent_;          // cha trong cây khử, NONE nếu là gốc
+
+    // Cung hướng lên: node v có các cung [upFirst_[v], upFirst_[v+1]), sắp theo hạng đầu kia
+    std::vector<uint32_t> upFirst_;
+    std::vector<uint32_t> arcTail_;
+    std::vector<uint32_t> arcHead_;
+
+    // Danh sách kề hướng xuống: node u có (node thấp v, cung v->u), sắp theo hạng v
+    std::vector<uint32_t> downFirst_;
+    std::vector<uint32_t> downNode_;
+    std::vector<uint32_t> downArc_;
+
+    // Các node theo tầng cây khử (tầng 0 = lá), dùng cho customize song song
+    std::vector<uint32_t> levelFirst_;
+    std::vector<uint32_t> levelNodes_;
+
+    // Edge gốc -> cung và chiều (true = up)
+    std::vector<uint32_t> inputArc_;
+    std::vector<uint8_t> inputUp_;
+
+    std::shared_ptr<const Metric> metric_;
+
+    std::shared_ptr<const Metric> currentMetric() const;
+    uint32_t findArc(uint32_t lower, uint32_t higher) const;
+    void unpack(const Metric& m, uint32_t arc, bool up, std::vector<uint32_t>& out) const;
+};
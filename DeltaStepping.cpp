@@ -0,0 +1,177 @@
+#include "DeltaStepping.h"
+#include "Parallel.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+using namespace std;
+
+namespace {
+    const double INF = numeric_limits<double>::infinity();
+
+    // Dưới ngưỡng này một pha chạy trên luồng gọi: tạo luồng đắt hơn phần việc
+    const size_t PARALLEL_THRESHOLD = 1024;
+}
+
+/**
+ * @brief Chọn delta = phân vị 99% của weight / bậc ra trung bình (chỉ Edge không
+ *        bị chặn, weight dương và nhỏ hơn NO_SPEED_WEIGHT).
+ */
+double DeltaStepping::autoDelta(const CompactGraph& g) {
+    vector<double> w;
+    w.reserve(g.numEdges());
+    for (uint32_t e = 0; e < g.numEdges(); e++)
+        if (!g.blocked[e] && g.weight[e] > 0 && g.weight[e] < CompactGraph::NO_SPEED_WEIGHT)
+            w.push_back(g.weight[e]);
+    if (w.empty() || g.numNodes() == 0) return 1;
+
+    size_t k = static_cast<size_t>(0.99 * (w.size() - 1));
+    nth_element(w.begin(), w.begin() + k, w.end());
+    double avgDegree = max(1.0, static_cast<double>(w.size()) / g.numNodes());
+    return w[k] / avgDegree;
+}
+
+void DeltaStepping::run(const CompactGraph& g, uint32_t source, vector<double>& dist,
+                        vector<uint32_t>* parentEdge) {
+    const uint32_t n = g.numNodes();
+    dist.assign(n, INF);
+    if (parentEdge) parentEdge->assign(n, CompactGraph::INVALID);
+    if (source >= n) return;
+
+    const unsigned threads = defaultThreadCount(threads_);
+    const double delta = delta_ > 0 ? delta_ : autoDelta(g);
+    lastDelta_ = delta;
+
+    buckets_.resize(RING_SIZE);
+    for (auto& b : buckets_) b.clear();
+    far_.clear();
+    requests_.resize(threads);
+    for (auto& perOwner : requests_) perOwner.resize(threads);
+    changed_.resize(threads);
+    phaseMark_.assign(n, 0);
+    inSettled_.assign(n, 0);
+    uint32_t phase = 0;
+
+    // Các luồng làm việc: tạo ở pha song song đầu tiên, dùng lại tới hết run()
+    unique_ptr<ThreadPool> pool;
+    auto forEachThread = [&](bool parallel, auto&& fn) {
+        if (!parallel || threads == 1) {
+            for (unsigned t = 0; t < threads; t++) fn(t);
+            return;
+        }
+        if (!pool) pool.reset(new ThreadPool(threads));
+        for (unsigned t = 0; t < threads; t++) pool->submit([&fn, t] { fn(t); });
+        pool->wait();
+    };
+
+    size_t current = 0;         // bucket đang xử lý; vòng chứa bucket [current, current + RING_SIZE)
+    size_t inRing = 0;          // số mục trong vòng (kể cả bản trùng, bản cũ)
+    size_t farMin = SIZE_MAX;   // cận dưới bucket của các node trong far_
+    auto bucketOf = [&](uint32_t v) { return static_cast<size_t>(dist[v] / delta); };
+
+    auto insert = [&](uint32_t v) {
+        size_t b = bucketOf(v);
+        if (b - current < RING_SIZE) {
+            buckets_[b % RING_SIZE].push_back(v);
+            inRing++;
+        } else {
+            far_.push_back(v);
+            farMin = min(farMin, b);
+        }
+    };
+
+    // Đưa node trong far_ có bucket đã vào vòng sang vòng; bỏ bản cũ đã được chốt
+    auto pullFar = [&]() {
+        size_t keep = 0;
+        farMin = SIZE_MAX;
+        for (uint32_t v : far_) {
+            size_t b = bucketOf(v);
+            if (b < current) continue;
+            if (b - current < RING_SIZE) {
+                buckets_[b % RING_SIZE].push_back(v);
+                inRing++;
+            } else {
+                far_[keep++] = v;
+                farMin = min(farMin, b);
+            }
+        }
+        far_.resize(keep);
+    };
+
+    // Nới lỏng cung nhẹ (light = true) hoặc nặng của các node trong list
+    auto relax = [&](const vector<uint32_t>& list, bool light) {
+        bool parallel = list.size() >= PARALLEL_THRESHOLD;
+        size_t per = (list.size() + threads - 1) / threads;
+
+        // 1. Sinh yêu cầu: luồng t đọc dist (không ghi), ghi vào requests_[t][chủ node]
+        forEachThread(parallel, [&](size_t t) {
+            auto& out = requests_[t];
+            for (auto& r : out) r.clear();
+            size_t end = min(list.size(), (t + 1) * per);
+            for (size_t i = t * per; i < end; i++) {
+                uint32_t v = list[i];
+                double d = dist[v];
+                for (ArcView arc : g.outArcs(v)) {
+                    if ((arc.weight <= delta) != light) continue;
+                    double nd = d + arc.weight;
+                    if (nd < dist[arc.target]) out[arc.target % threads].push_back({arc.target, arc.edge, nd});
+                }
+            }
+        });
+
+        // 2. Áp dụng: luồng o chỉ ghi dist của node thuộc về nó
+        forEachThread(parallel, [&](size_t o) {
+            changed_[o].clear();
+            for (unsigned t = 0; t < threads; t++) {
+                for (const Request& r : requests_[t][o]) {
+                    if (r.dist < dist[r.node]) {
+                        dist[r.node] = r.dist;
+                        if (parentEdge) (*parentEdge)[r.node] = r.edge;
+                        changed_[o].push_back(r.node);
+                    }
+                }
+            }
+        });
+
+        for (const auto& c : changed_)
+            for (uint32_t v : c) insert(v);
+    };
+
+    dist[source] = 0;
+    insert(source);
+
+    while (inRing > 0 || !far_.empty()) {
+        if (inRing == 0) current = max(current, farMin);    // nhảy qua dải bucket rỗng
+        if (farMin < current + RING_SIZE) pullFar();
+        auto& bucket = buckets_[current % RING_SIZE];
+
+        settled_.clear();
+        while (!bucket.empty()) {
+            // Lấy bucket ra; bỏ bản trùng và node đã bị giảm sang bucket khác
+            frontier_.clear();
+            phase++;
+            for (uint32_t v : bucket) {
+                if (phaseMark_[v] == phase || bucketOf(v) != current) continue;
+                phaseMark_[v] = phase;
+                frontier_.push_back(v);
+            }
+            inRing -= bucket.size();
+            bucket.clear();
+
+            relax(frontier_, true);
+            for (uint32_t v : frontier_) {
+                if (!inSettled_[v]) {
+                    inSettled_[v] = 1;
+                    settled_.push_back(v);
+                }
+            }
+        }
+
+        relax(settled_, false);
+        for (uint32_t v : settled_) inSettled_[v] = 0;
+        current++;
+    }
+}
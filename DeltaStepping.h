@@ -0,0 +1,58 @@
+#pragma once
+#include "CompactGraph.h"
+#include <cstdint>
+#include <vector>
+
+// Delta-stepping (Meyer & Sanders) song song cho bài toán một - tất cả.
+// Node được xếp vào bucket theo floor(dist / delta). Bucket nhỏ nhất được xử lý
+// theo từng pha: nới lỏng cung nhẹ (weight <= delta) của mọi node trong bucket cùng
+// lúc, lặp tới khi bucket rỗng, rồi nới lỏng cung nặng của các node đã chốt một lần.
+// Trong mỗi pha, các luồng sinh yêu cầu nới lỏng vào bộ đệm riêng, chia sẵn theo
+// luồng sở hữu node đích (node % số luồng); sau đó mỗi luồng áp dụng các yêu cầu
+// cho node của mình, nên không cần khóa hay phép nguyên tử trên dist. Edge bị chặn
+// được bỏ qua; không tính chi phí rẽ.
+// Bucket nằm trên một vòng RING_SIZE bucket tính từ bucket đang xử lý; node ở xa
+// hơn (sau Edge rất dài, vd. Edge tốc độ 0) chờ trong danh sách riêng và được
+// chuyển vào vòng khi tới gần, nên bộ nhớ không phụ thuộc khoảng cách lớn nhất.
+// Các luồng làm việc được tạo một lần cho mỗi run() và dùng lại qua mọi pha.
+class DeltaStepping {
+public:
+    // threads = 0: dùng std::thread::hardware_concurrency()
+    void setThreads(unsigned threads) { threads_ = threads; }
+    // Độ rộng bucket (giờ); 0 = tự chọn theo phân bố weight (xem autoDelta)
+    void setDelta(double delta) { delta_ = delta; }
+    // Độ rộng bucket của lần chạy gần nhất
+    double lastDelta() const { return lastDelta_; }
+
+    // Theo Meyer & Sanders, delta ~ weight lớn nhất / bậc trung bình; lấy phân vị
+    // 99% của weight thay cho giá trị lớn nhất để một Edge bất thường không kéo lệch
+    static double autoDelta(const CompactGraph& g);
+
+    // dist[v] = thời gian đi ngắn nhất từ source, vô cực nếu không tới được.
+    // parentEdge (nếu có) nhận Edge cuối trên một đường ngắn nhất, INVALID ở source.
+    void run(const CompactGraph& g, uint32_t source, std::vector<double>& dist,
+             std::vector<uint32_t>* parentEdge = nullptr);
+
+private:
+    struct Request {
+        uint32_t node;
+        uint32_t edge;
+        double dist;
+    };
+
+    unsigned threads_ = 0;
+    double delta_ = 0;
+    double lastDelta_ = 0;
+
+    static constexpr size_t RING_SIZE = 1024;
+
+    // Bộ nhớ giữ lại giữa các lần chạy
+    std::vector<std::vector<uint32_t>> buckets_;                // vòng RING_SIZE bucket
+    std::vector<uint32_t> far_;                                 // node có bucket ngoài vòng
+    std::vector<std::vector<std::vector<Request>>> requests_;   // [luồng sinh][luồng sở hữu]
+    std::vector<std::vector<uint32_t>> changed_;                // node được giảm dist, theo luồng sở hữu
+    std::vector<uint32_t> frontier_;
+    std::vector<uint32_t> settled_;
+    std::vector<uint32_t> phaseMark_;
+    std::vector<uint8_t> inSettled_;
+};
@@ -0,0 +1,219 @@
+#include "DynamicShortestPath.h"
+#include "SearchWorkspace.h"
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+namespace {
+    const double INF = numeric_limits<double>::infinity();
+    const uint32_t NONE = CompactGraph::INVALID;
+}
+
+DynamicShortestPath::DynamicShortestPath(RoadMap& map) : map_(map) {}
+
+bool DynamicShortestPath::setSource(const string& start) {
+    return setSource(map_.graph().findNode(start));
+}
+
+bool DynamicShortestPath::setSource(uint32_t source) {
+    const CompactGraph& g = map_.graph();
+    if (source >= g.numNodes()) return false;
+    source_ = source;
+    sourceId_ = g.nodeIds[source];
+    rebuild(g);
+    return true;
+}
+
+/**
+ * @brief Dijkstra một - tất cả từ nguồn, ghi lại cây và vị trí hiện tại của nhật ký.
+ */
+void DynamicShortestPath::rebuild(const CompactGraph& g) {
+    const uint32_t n = g.numNodes();
+    dist_.assign(n, INF);
+    parent_.assign(n, NONE);
+    inSubtree_.assign(n, 0);
+    touched_.assign(n, 0);
+    stamp_ = 0;
+    version_ = g.version;
+    applied_ = g.changeCount();
+    fullRebuilds_++;
+
+    SearchWorkspace& ws = SearchWorkspace::forThread();
+    ws.reset(n);
+    dist_[source_] = 0;
+    ws.push(0, source_);
+    while (!ws.empty()) {
+        auto [d, u] = ws.pop();
+        if (d > dist_[u]) continue;
+        for (ArcView arc : g.outArcs(u)) {
+            double nd = d + arc.weight;
+            if (nd < dist_[arc.target]) {
+                dist_[arc.target] = nd;
+                parent_[arc.target] = arc.edge;
+                ws.push(nd, arc.target);
+            }
+        }
+    }
+}
+
+size_t DynamicShortestPath::update() {
+    if (source_ == NONE) return 0;
+    const CompactGraph& g = map_.graph();
+    if (g.version != version_) {
+        // chỉ số node có thể đã đổi; nguồn bị xóa khỏi bản đồ thì cây rỗng
+        source_ = g.findNode(sourceId_);
+        if (source_ == NONE) {
+            dist_.clear();
+            parent_.clear();
+            return 0;
+        }
+    }
+    if (g.version != version_ || applied_ < g.changeLogStart) {
+        rebuild(g);
+        return g.numNodes();
+    }
+    if (applied_ == g.changeCount()) return 0;
+
+    size_t first = static_cast<size_t>(applied_ - g.changeLogStart);
+    applied_ = g.changeCount();
+    return repair(g, first);
+}
+
+/**
+ * @brief Sửa cây theo các Edge đã đổi (changeLog[first..]).
+ *        1. Edge cây u -> v bị chặn hoặc có dist(u) + w > dist(v): v là gốc một cây
+ *           con mất khoảng cách; gom cả cây con (con là node có Edge cha xuất phát
+ *           từ node trong cây con) và đặt khoảng cách vô cực.
+ *        2. Mỗi node trong cây con nhận khoảng cách tốt nhất qua cung vào từ node
+ *           ngoài cây con; mỗi Edge đổi không bị chặn mà đi qua nó rẻ hơn thì hạ
+ *           node đích. Các node này là hạt giống của hàng đợi.
+ *        3. Dijkstra từ các hạt giống, chỉ đi tiếp qua node giảm được khoảng cách.
+ *        Node ngoài cây con giữ khoảng cách cũ, là độ dài một đường còn tồn tại nên
+ *        là cận trên hợp lệ; mọi cung có thể làm giảm nó đều xuất phát từ một hạt
+ *        giống hoặc một node được lan tới, nên kết quả trùng Dijkstra từ đầu.
+ */
+size_t DynamicShortestPath::repair(const CompactGraph& g, size_t first) {
+    if (++stamp_ == 0) {
+        fill(inSubtree_.begin(), inSubtree_.end(), 0);
+        fill(touched_.begin(), touched_.end(), 0);
+        stamp_ = 1;
+    }
+    size_t changedNodes = 0;
+    auto touch = [&](uint32_t v) {
+        if (touched_[v] != stamp_) {
+            touched_[v] = stamp_;
+            changedNodes++;
+        }
+    };
+
+    // 1. Gốc các cây con có Edge cha xấu đi
+    affected_.clear();
+    for (size_t i = first; i < g.changeLog.size(); i++) {
+        uint32_t e = g.changeLog[i];
+        uint32_t v = g.head[e];
+        if (parent_[v] != e || inSubtree_[v] == stamp_) continue;
+        double via = g.blocked[e] ? INF : dist_[g.tail[e]] + g.weight[e];
+        if (via > dist_[v]) {
+            inSubtree_[v] = stamp_;
+            affected_.push_back(v);
+        }
+    }
+    // duyệt thẳng mảng CSR: Edge cha của cây có thể đang bị chặn
+    for (size_t i = 0; i < affected_.size(); i++) {
+        uint32_t x = affected_[i];
+        for (uint32_t e = g.firstOut[x]; e < g.firstOut[x + 1]; e++) {
+            uint32_t y = g.head[e];
+            if (parent_[y] == e && inSubtree_[y] != stamp_) {
+                inSubtree_[y] = stamp_;
+                affected_.push_back(y);
+            }
+        }
+    }
+    for (uint32_t x : affected_) {
+        dist_[x] = INF;
+        parent_[x] = NONE;
+        touch(x);
+    }
+
+    // 2. Hạt giống
+    SearchWorkspace& ws = SearchWorkspace::forThread();
+    ws.reset(g.numNodes());
+    for (uint32_t x : affected_) {
+        for (ArcView arc : g.inArcs(x)) {
+            if (inSubtree_[arc.target] == stamp_) continue;
+            double nd = dist_[arc.target] + arc.weight;
+            if (nd < dist_[x]) {
+                dist_[x] = nd;
+                parent_[x] = arc.edge;
+            }
+        }
+        if (dist_[x] < INF) ws.push(dist_[x], x);
+    }
+    for (size_t i = first; i < g.changeLog.size(); i++) {
+        uint32_t e = g.changeLog[i];
+        uint32_t u = g.tail[e], v = g.head[e];
+        if (g.blocked[e] || inSubtree_[u] == stamp_) continue;
+        double nd = dist_[u] + g.weight[e];
+        if (nd < dist_[v]) {
+            dist_[v] = nd;
+            parent_[v] = e;
+            touch(v);
+            ws.push(nd, v);
+        }
+    }
+
+    // 3. Lan truyền
+    while (!ws.empty()) {
+        auto [d, u] = ws.pop();
+        if (d > dist_[u]) continue;
+        for (ArcView arc : g.outArcs(u)) {
+            double nd = d + arc.weight;
+            if (nd < dist_[arc.target]) {
+                dist_[arc.target] = nd;
+                parent_[arc.target] = arc.edge;
+                touch(arc.target);
+                ws.push(nd, arc.target);
+            }
+        }
+    }
+    return changedNodes;
+}
+
+double DynamicShortestPath::travelTime(const string& goal) {
+    update();
+    return travelTime(map_.graph().findNode(goal));
+}
+
+double DynamicShortestPath::travelTime(uint32_t target) {
+    update();
+    if (source_ == NONE || target >= dist_.size() || dist_[target] == INF) return -1;
+    return dist_[target];
+}
+
+double DynamicShortestPath::findRoute(const string& goal, EdgeRoute& out) {
+    update();
+    return findRoute(map_.graph().findNode(goal), out);
+}
+
+/**
+ * @brief Truy vết Edge cha từ đích về nguồn rồi cộng dồn thời gian.
+ */
+double DynamicShortestPath::findRoute(uint32_t target, EdgeRoute& out) {
+    out.clear();
+    double d = travelTime(target);
+    if (d < 0) return -1;
+
+    const CompactGraph& g = map_.graph();
+    for (uint32_t v = target; v != source_; v = g.tail[parent_[v]])
+        out.steps.push_back({parent_[v], 0});
+    reverse(out.steps.begin(), out.steps.end());
+    double time = 0;
+    for (RouteStep& s : out.steps) {
+        time += g.weight[s.edge];
+        s.time = time;
+    }
+    out.source = source_;
+    out.cost = d;
+    return d;
+}
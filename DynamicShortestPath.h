@@ -0,0 +1,65 @@
+#pragma once
+#include "RoadMap.h"
+#include "ShortestPath.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Cây đường ngắn nhất động từ một node nguồn, theo thời gian đi.
+// Cây được tính một lần bằng Dijkstra; sau đó mỗi lần đọc, cây đồng bộ với các
+// Edge mà RoadMap đã chặn/bỏ chặn hay đổi tốc độ kể từ lần trước (nhật ký
+// CompactGraph::changeLog) và chỉ sửa phần bị ảnh hưởng, theo kiểu Ramalingam - Reps:
+//  - Edge cây bị chặn hoặc chậm đi: cả cây con dưới nó mất khoảng cách; mỗi node
+//    trong cây con lấy lại khoảng cách tốt nhất qua cung vào từ phần còn nguyên,
+//    rồi Dijkstra chỉ lan trong cây con đó.
+//  - Edge được bỏ chặn hoặc nhanh lên: nếu đi qua nó rẻ hơn thì Dijkstra lan từ
+//    node đích của Edge, chỉ qua các node thực sự giảm khoảng cách.
+// Khi bản đồ dựng lại đồ thị (addEdge, loadFromFile, ...) hoặc nhật ký đã bỏ các
+// mục cây chưa đọc, cây được tính lại từ đầu. Không tính chi phí rẽ.
+class DynamicShortestPath {
+public:
+    DynamicShortestPath(RoadMap& map);
+
+    // Đặt nguồn và tính cây từ đầu; false nếu node không tồn tại
+    bool setSource(const std::string& start);
+    bool setSource(uint32_t source);
+    uint32_t source() const { return source_; }
+
+    // Đồng bộ cây với bản đồ; trả về số node có khoảng cách hoặc Edge cha thay đổi.
+    // Các hàm đọc bên dưới tự gọi update().
+    size_t update();
+
+    // Thời gian đi ngắn nhất tới target, -1 nếu không tới được
+    double travelTime(const std::string& goal);
+    double travelTime(uint32_t target);
+
+    // Tuyến theo Edge trên cây (xem EdgeRoute); -1 nếu không tới được
+    double findRoute(const std::string& goal, EdgeRoute& out);
+    double findRoute(uint32_t target, EdgeRoute& out);
+
+    // Số lần tính lại toàn bộ cây (kể cả lần setSource đầu tiên)
+    size_t fullRebuilds() const { return fullRebuilds_; }
+
+private:
+    RoadMap& map_;
+    uint32_t source_ = CompactGraph::INVALID;
+    std::string sourceId_;          // để tìm lại nguồn khi đồ thị được dựng lại
+    uint64_t version_ = 0;          // graph().version của cây
+    uint64_t applied_ = 0;          // số thay đổi trong nhật ký đã áp dụng
+    size_t fullRebuilds_ = 0;
+
+    std::vector<double> dist_;
+    std::vector<uint32_t> parent_;  // Edge cuối trên đường cây, INVALID ở nguồn/node không tới được
+
+    // Bộ nhớ làm việc của lần sửa, đánh dấu theo tem: node thuộc cây con bị ảnh
+    // hưởng, node đã đổi nhãn
+    std::vector<uint32_t> inSubtree_;
+    std::vector<uint32_t> touched_;
+    uint32_t stamp_ = 0;
+    std::vector<uint32_t> affected_;
+
+    void rebuild(const CompactGraph& g);
+    // Áp dụng changeLog từ vị trí first tới cuối
+    size_t repair(const CompactGraph& g, size_t first);
+};
@@ -0,0 +1,17 @@
+#pragma once
+#include <cmath>
+#include <algorithm>
+
+// Bán kính trung bình của Trái Đất (km)
+constexpr double EARTH_RADIUS_KM = 6371.0088;
+
+// Khoảng cách đường tròn lớn (km) giữa hai điểm theo độ
+inline double haversineKm(double lat1, double lon1, double lat2, double lon2) {
+    const double toRad = M_PI / 180.0;
+    double dLat = (lat2 - lat1) * toRad;
+    double dLon = (lon2 - lon1) * toRad;
+    double a = std::sin(dLat / 2) * std::sin(dLat / 2) +
+               std::cos(lat1 * toRad) * std::cos(lat2 * toRad) *
+               std::sin(dLon / 2) * std::sin(dLon / 2);
+    return 2 * EARTH_RADIUS_KM * std::asin(std::sqrt(std::min(1.0, a)));
+}
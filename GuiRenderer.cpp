@@ -249,7 +249,7 @@ void GuiRenderer::latLonToScreen(double lat, double lon, int& x, int& y,
 
 void GuiRenderer::drawMap(RoadMap& map, int offsetX, int offsetY, double scale) {
     auto nodeIds = map.getNodeIds();
-    auto edges = map.getEdges();
+    const CompactGraph& g = map.graph();
     
     if (nodeIds.empty()) {
         drawText("Bản đồ trống", offsetX + 150, offsetY + 100, Color(150, 150, 150));
@@ -276,7 +276,8 @@ void GuiRenderer::drawMap(RoadMap& map, int offsetX, int offsetY, double scale)
     double centerLon = (minLon + maxLon) / 2.0;
     
     // Vẽ edges với màu dựa trên traffic load
-    for (const auto& edge :  edges) {
+    for (uint32_t a = 0; a < g.numEdges(); a++) {
+        const Edge& edge = map.edgeAt(a);
         if (! edge.isReverse) {
             auto srcNode = map.getNodeById(edge.src);
             auto dstNode = map.getNodeById(edge.dst);
@@ -339,82 +340,113 @@ void GuiRenderer::drawMapEdge(double x1, double y1, double x2, double y2,
              static_cast<int>(x2), static_cast<int>(y2), color, thickness);
 }
 
-void GuiRenderer::highlightPath(RoadMap& map, const std::vector<std::string>& path, 
+void GuiRenderer::highlightPath(RoadMap& map, const EdgeRoute& route,
                                 int offsetX, int offsetY, double scale) {
     (void)scale;  // Unused parameter - we calculate our own scale
-    
-    if (path.size() < 2) return;
-    
-    auto nodeIds = map.getNodeIds();
-    if (nodeIds.empty()) return;
-    
+
+    const CompactGraph& g = map.graph();
+    if (!route.found() || route.steps.empty() || g.numNodes() == 0) return;
+
     // Calculate bounding box and auto-scale (same as drawMap)
     double minLat = 1e9, maxLat = -1e9, minLon = 1e9, maxLon = -1e9;
-    for (const auto& nodeId : nodeIds) {
-        auto node = map.getNodeById(nodeId);
-        if (node) {
-            minLat = std::min(minLat, node->lat);
-            maxLat = std::max(maxLat, node->lat);
-            minLon = std::min(minLon, node->lon);
-            maxLon = std::max(maxLon, node->lon);
-        }
+    for (uint32_t v = 0; v < g.numNodes(); v++) {
+        minLat = std::min(minLat, g.lat[v]);
+        maxLat = std::max(maxLat, g.lat[v]);
+        minLon = std::min(minLon, g.lon[v]);
+        maxLon = std::max(maxLon, g.lon[v]);
     }
-    
+
     double latRange = maxLat - minLat;
     double lonRange = maxLon - minLon;
     double autoScale = std::min(380.0 / (latRange * 1000), 420.0 / (lonRange * 1000)) * 0.9;
     double centerLat = (minLat + maxLat) / 2.0;
     double centerLon = (minLon + maxLon) / 2.0;
-    
+
+    auto toX = [&](uint32_t v) { return static_cast<int>((g.lon[v] - centerLon) * autoScale * 1000) + offsetX + 210; };
+    auto toY = [&](uint32_t v) { return static_cast<int>((centerLat - g.lat[v]) * autoScale * 1000) + offsetY + 190; };
+
     // Draw highlighted path with edge IDs
-    for (size_t i = 0; i < path.size() - 1; i++) {
-        auto srcNode = map.getNodeById(path[i]);
-        auto dstNode = map.getNodeById(path[i+1]);
-        
-        if (srcNode && dstNode) {
-            int x1 = static_cast<int>((srcNode->lon - centerLon) * autoScale * 1000) + offsetX + 210;
-            int y1 = static_cast<int>((centerLat - srcNode->lat) * autoScale * 1000) + offsetY + 190;
-            int x2 = static_cast<int>((dstNode->lon - centerLon) * autoScale * 1000) + offsetX + 210;
-            int y2 = static_cast<int>((centerLat - dstNode->lat) * autoScale * 1000) + offsetY + 190;
-            
-            // Draw thick highlighted line
-            drawLine(x1, y1, x2, y2, Color(255, 200, 0), 6);  // Thicker yellow highlight
-            
-            // Get and display edge ID
-            std::string edgeId = getEdgeIdBetweenNodes(map, path[i], path[i+1]);
-            if (!edgeId.empty()) {
-                int midX = (x1 + x2) / 2;
-                int midY = (y1 + y2) / 2;
-                
-                // Draw background for edge ID text
-                drawRect(midX - 20, midY - 10, 40, 20, Color(50, 50, 50, 200), true);
-                drawText(edgeId, midX - 15, midY - 8, Color(255, 255, 100), 16);
-            }
-        }
-    }
-    
-    // Draw path nodes with larger highlight
-    for (const auto& nodeId : path) {
-        auto node = map.getNodeById(nodeId);
-        if (node) {
-            int x = static_cast<int>((node->lon - centerLon) * autoScale * 1000) + offsetX + 210;
-            int y = static_cast<int>((centerLat - node->lat) * autoScale * 1000) + offsetY + 190;
-            
-            drawCircle(x, y, 10, Color(255, 200, 0), true);
-            drawCircle(x, y, 10, Color(255, 255, 255), false);
-            drawText(nodeId, x + 12, y - 5, Color(255, 255, 100));
-        }
+    for (const RouteStep& step : route.steps) {
+        int x1 = toX(g.tail[step.edge]), y1 = toY(g.tail[step.edge]);
+        int x2 = toX(g.head[step.edge]), y2 = toY(g.head[step.edge]);
+
+        // Draw thick highlighted line
+        drawLine(x1, y1, x2, y2, Color(255, 200, 0), 6);  // Thicker yellow highlight
+
+        int midX = (x1 + x2) / 2;
+        int midY = (y1 + y2) / 2;
+
+        // Draw background for edge ID text
+        drawRect(midX - 20, midY - 10, 40, 20, Color(50, 50, 50, 200), true);
+        drawText(g.edgeIds[step.edge], midX - 15, midY - 8, Color(255, 255, 100), 16);
     }
+
+    // Draw path nodes with larger highlight, labelled with arrival time in minutes
+    auto drawPathNode = [&](uint32_t v, double time) {
+        int x = toX(v), y = toY(v);
+        drawCircle(x, y, 10, Color(255, 200, 0), true);
+        drawCircle(x, y, 10, Color(255, 255, 255), false);
+        drawText(g.nodeIds[v] + " (" + std::to_string(static_cast<int>(time * 60)) + "')",
+                 x + 12, y - 5, Color(255, 255, 100));
+    };
+    drawPathNode(route.source, 0);
+    for (const RouteStep& step : route.steps) drawPathNode(g.head[step.edge], step.time);
 }
 
-std::string GuiRenderer::getEdgeIdBetweenNodes(RoadMap& map, const std::string& srcNode, const std::string& dstNode) {
-    auto edges = map.outgoingEdges(srcNode);
-    for (const auto& edge : edges) {
-        if (edge.dst == dstNode) {
-            return edge.id;
-        }
+void GuiRenderer::shadeIsochrone(RoadMap& map, const IsochroneResult& iso,
+                                 int offsetX, int offsetY, double scale) {
+    (void)scale;  // Unused parameter - we calculate our own scale
+
+    const CompactGraph& g = map.graph();
+    if (g.numNodes() == 0 || iso.nodes.empty()) return;
+
+    // Calculate bounding box and auto-scale (same as drawMap)
+    double minLat = 1e9, maxLat = -1e9, minLon = 1e9, maxLon = -1e9;
+    for (uint32_t v = 0; v < g.numNodes(); v++) {
+        minLat = std::min(minLat, g.lat[v]);
+        maxLat = std::max(maxLat, g.lat[v]);
+        minLon = std::min(minLon, g.lon[v]);
+        maxLon = std::max(maxLon, g.lon[v]);
+    }
+
+    double latRange = maxLat - minLat;
+    double lonRange = maxLon - minLon;
+    double autoScale = std::min(380.0 / (latRange * 1000), 420.0 / (lonRange * 1000)) * 0.9;
+    double centerLat = (minLat + maxLat) / 2.0;
+    double centerLon = (minLon + maxLon) / 2.0;
+
+    auto toX = [&](uint32_t v) { return static_cast<int>((g.lon[v] - centerLon) * autoScale * 1000) + offsetX + 210; };
+    auto toY = [&](uint32_t v) { return static_cast<int>((centerLat - g.lat[v]) * autoScale * 1000) + offsetY + 190; };
+
+    // Gần nguồn: xanh lơ, gần hết ngân sách: tím
+    auto shade = [&](double t) {
+        double k = iso.budget > 0 ? std::min(1.0, t / iso.budget) : 1.0;
+        return Color(static_cast<Uint8>(40 + 160 * k), static_cast<Uint8>(200 - 140 * k), 230);
+    };
+
+    std::vector<double> arrival(g.numNodes(), -1);
+    for (const auto& r : iso.nodes) arrival[r.node] = r.time;
+
+    // Edge nằm trọn trong vùng
+    for (uint32_t a = 0; a < g.numEdges(); a++) {
+        uint32_t u = g.tail[a], v = g.head[a];
+        if (g.blocked[a] || arrival[u] < 0 || arrival[u] + g.weight[a] > iso.budget) continue;
+        drawLine(toX(u), toY(u), toX(v), toY(v), shade(arrival[u] + g.weight[a]), 5);
+    }
+
+    // Edge biên: chỉ phần đi được
+    for (const auto& b : iso.boundary) {
+        uint32_t u = g.tail[b.edge], v = g.head[b.edge];
+        int x1 = toX(u), y1 = toY(u);
+        int x2 = x1 + static_cast<int>((toX(v) - x1) * b.fraction);
+        int y2 = y1 + static_cast<int>((toY(v) - y1) * b.fraction);
+        drawLine(x1, y1, x2, y2, shade(iso.budget), 5);
+    }
+
+    for (const auto& r : iso.nodes) {
+        drawCircle(toX(r.node), toY(r.node), 7, shade(r.time), true);
+        drawCircle(toX(r.node), toY(r.node), 7, Color(255, 255, 255), false);
     }
-    return "";
 }
 
 void GuiRenderer::drawTitle(const std::string& title) {
@@ -5,6 +5,7 @@
 #include <vector>
 #include <memory>
 #include "RoadMap.h"
+#include "ShortestPath.h"
 
 // Colors
 struct Color {
@@ -61,8 +62,11 @@ public:
     void drawMap(RoadMap& map, int offsetX, int offsetY, double scale);
     void drawMapNode(const std::string& nodeId, double x, double y, const Color& color, int radius = 8);
     void drawMapEdge(double x1, double y1, double x2, double y2, const Color& color, int thickness = 2);
-    void highlightPath(RoadMap& map, const std::vector<std::string>& path, int offsetX, int offsetY, double scale);
-    std::string getEdgeIdBetweenNodes(RoadMap& map, const std::string& srcNode, const std::string& dstNode);
+    // Tô tuyến theo đúng các Edge đã chọn, ghi thời gian tới (phút) cạnh mỗi node
+    void highlightPath(RoadMap& map, const EdgeRoute& route, int offsetX, int offsetY, double scale);
+    // Tô vùng tới được: Edge nằm trọn trong ngân sách tô đậm theo thời gian tới,
+    // Edge biên chỉ tô phần đi được, node tới được vẽ chấm màu
+    void shadeIsochrone(RoadMap& map, const IsochroneResult& iso, int offsetX, int offsetY, double scale);
     
     // Helper functions
     void drawTitle(const std::string& title);
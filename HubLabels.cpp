@@ -0,0 +1,300 @@
+#include "HubLabels.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <utility>
+
+using namespace std;
+
+namespace {
+    const double INF = numeric_limits<double>::infinity();
+
+    const uint32_t FILE_MAGIC = 0x4C425548;   // "HUBL"
+    const uint32_t FILE_FORMAT = 1;
+
+    using Label = vector<pair<uint32_t, double>>;     // (hạng hub, khoảng cách), sắp theo hạng
+
+    double mergeLabels(const Label& a, const Label& b) {
+        double best = INF;
+        size_t i = 0, j = 0;
+        while (i < a.size() && j < b.size()) {
+            if (a[i].first == b[j].first) {
+                best = min(best, a[i].second + b[j].second);
+                i++;
+                j++;
+            } else if (a[i].first < b[j].first) {
+                i++;
+            } else {
+                j++;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @brief Nhãn ứng viên của v: (v, 0) cộng nhãn của các láng giềng hạng cao
+     *        dịch thêm weight cung; giữ khoảng cách nhỏ nhất cho mỗi hub.
+     */
+    template <class Arcs>
+    Label collectLabel(uint32_t selfRank, const Arcs& arcs, const vector<Label>& labels) {
+        Label cand{{selfRank, 0.0}};
+        for (const CHArc& arc : arcs)
+            for (const auto& e : labels[arc.node]) cand.push_back({e.first, e.second + arc.weight});
+        sort(cand.begin(), cand.end());
+        Label out;
+        out.reserve(cand.size());
+        for (const auto& e : cand)
+            if (out.empty() || out.back().first != e.first) out.push_back(e);
+        return out;
+    }
+
+    // FNV-1a trên topology và weight, để nhận ra tệp nhãn dựng cho bản đồ khác
+    uint64_t graphFingerprint(const CompactGraph& g) {
+        uint64_t h = 1469598103934665603ull;
+        auto mix = [&h](const void* data, size_t bytes) {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < bytes; i++) {
+                h ^= p[i];
+                h *= 1099511628211ull;
+            }
+        };
+        uint32_t n = g.numNodes(), m = g.numEdges();
+        mix(&n, sizeof(n));
+        mix(&m, sizeof(m));
+        mix(g.firstOut.data(), g.firstOut.size() * sizeof(uint32_t));
+        mix(g.head.data(), g.head.size() * sizeof(uint32_t));
+        mix(g.weight.data(), g.weight.size() * sizeof(double));
+        return h;
+    }
+
+    template <class T>
+    void writePod(ofstream& f, const T& v) { f.write(reinterpret_cast<const char*>(&v), sizeof(T)); }
+    template <class T>
+    bool readPod(ifstream& f, T& v) { return static_cast<bool>(f.read(reinterpret_cast<char*>(&v), sizeof(T))); }
+
+    template <class Vec>
+    void writeArray(ofstream& f, const Vec& v) {
+        f.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(typename Vec::value_type));
+    }
+    // Không cấp phát theo số lượng đọc từ tệp khi tệp không đủ dữ liệu cho số đó
+    template <class Vec>
+    bool readArray(ifstream& f, Vec& v, uint64_t count) {
+        streamoff pos = f.tellg();
+        f.seekg(0, ios::end);
+        streamoff end = f.tellg();
+        f.seekg(pos);
+        if (pos < 0 || end < pos ||
+            count > static_cast<uint64_t>(end - pos) / sizeof(typename Vec::value_type)) return false;
+        v.resize(count);
+        return static_cast<bool>(
+            f.read(reinterpret_cast<char*>(v.data()), count * sizeof(typename Vec::value_type)));
+    }
+}
+
+/**
+ * @brief Dựng nhãn từ phân cấp: xử lý node từ hạng cao xuống theo tầng (các node
+ *        cùng tầng không phụ thuộc nhau nên chạy song song). Mục (h, d) của nhãn
+ *        xuôi bị bỏ nếu nhãn hiện tại và Lb(h) đã cho đường ngắn hơn d (mục bị trội),
+ *        tương tự cho nhãn ngược.
+ */
+void HubLabels::build(const CompactGraph& g, const ContractionHierarchy& ch, unsigned threads) {
+    if (!ch.isValidFor(g)) {
+        build(g, threads);
+        return;
+    }
+    threads = defaultThreadCount(threads);
+    const uint32_t n = g.numNodes();
+
+    vector<uint32_t> byRank(n);
+    for (uint32_t v = 0; v < n; v++) byRank[ch.rank(v)] = v;
+
+    // Tầng 0 = không có láng giềng hạng cao hơn; tầng của v lớn hơn tầng mọi láng giềng đó
+    vector<uint32_t> level(n, 0);
+    uint32_t maxLevel = 0;
+    for (uint32_t r = n; r-- > 0;) {
+        uint32_t v = byRank[r];
+        for (const CHArc& a : ch.upArcs(v)) level[v] = max(level[v], level[a.node] + 1);
+        for (const CHArc& a : ch.downArcs(v)) level[v] = max(level[v], level[a.node] + 1);
+        maxLevel = max(maxLevel, level[v]);
+    }
+    vector<vector<uint32_t>> levels(n ? maxLevel + 1 : 0);
+    for (uint32_t v = 0; v < n; v++) levels[level[v]].push_back(v);
+
+    vector<Label> fw(n), bw(n);
+    unique_ptr<ThreadPool> pool;
+    if (threads > 1) pool.reset(new ThreadPool(threads - 1));
+    for (const auto& nodes : levels) {
+        parallelFor(pool.get(), nodes.size(), [&](size_t i) {
+            uint32_t v = nodes[i];
+            uint32_t rv = ch.rank(v);
+
+            Label cand = collectLabel(rv, ch.upArcs(v), fw);
+            Label& lf = fw[v];
+            for (const auto& e : cand)
+                if (e.first == rv || !(mergeLabels(cand, bw[byRank[e.first]]) < e.second))
+                    lf.push_back(e);
+
+            cand = collectLabel(rv, ch.downArcs(v), bw);
+            Label& lb = bw[v];
+            for (const auto& e : cand)
+                if (e.first == rv || !(mergeLabels(fw[byRank[e.first]], cand) < e.second))
+                    lb.push_back(e);
+        }, 16);
+    }
+
+    // Làm phẳng: mỗi nhãn + lính canh, đệm tới bội số của một dòng cache
+    numEntries_ = 0;
+    auto flatten = [&](vector<Label>& labels, LabelSet& out) {
+        out.first.assign(n + 1, 0);
+        for (uint32_t v = 0; v < n; v++) {
+            uint32_t len = static_cast<uint32_t>(labels[v].size()) + 1;
+            len = (len + ENTRIES_PER_LINE - 1) / ENTRIES_PER_LINE * ENTRIES_PER_LINE;
+            out.first[v + 1] = out.first[v] + len;
+            numEntries_ += labels[v].size();
+        }
+        out.hubs.assign(out.first[n], SENTINEL);
+        out.dists.assign(out.first[n], INF);
+        for (uint32_t v = 0; v < n; v++) {
+            uint32_t p = out.first[v];
+            for (const auto& e : labels[v]) {
+                out.hubs[p] = e.first;
+                out.dists[p] = e.second;
+                p++;
+            }
+            Label().swap(labels[v]);
+        }
+    };
+    flatten(fw, forward_);
+    flatten(bw, backward_);
+
+    numNodes_ = n;
+    version_ = g.version;
+    weightVersion_ = g.weightVersion;
+    fingerprint_ = graphFingerprint(g);
+    built_ = true;
+}
+
+void HubLabels::build(const CompactGraph& g, unsigned threads) {
+    ContractionHierarchy ch;
+    ch.build(g, threads);
+    build(g, ch, threads);
+}
+
+/**
+ * @brief Trộn hai nhãn đã sắp theo hạng hub; cả hai đều kết thúc bằng SENTINEL.
+ */
+double HubLabels::merge(const uint32_t* h1, const double* d1, const uint32_t* h2, const double* d2) {
+    double best = INF;
+    size_t i = 0, j = 0;
+    while (true) {
+        uint32_t a = h1[i], b = h2[j];
+        if (a == b) {
+            if (a == SENTINEL) break;
+            double c = d1[i] + d2[j];
+            best = c < best ? c : best;
+            i++;
+            j++;
+        } else {
+            i += a < b;
+            j += b < a;
+        }
+    }
+    return best;
+}
+
+double HubLabels::distance(uint32_t source, uint32_t target) const {
+    if (!built_ || source >= numNodes_ || target >= numNodes_) return -1;
+    if (source == target) return 0;
+    uint32_t a = forward_.first[source], b = backward_.first[target];
+    double d = merge(forward_.hubs.data() + a, forward_.dists.data() + a,
+                     backward_.hubs.data() + b, backward_.dists.data() + b);
+    return d == INF ? -1 : d;
+}
+
+/**
+ * @brief Ghi nhãn ra tệp nhị phân (thứ tự byte của máy hiện tại).
+ */
+bool HubLabels::save(const string& filename) const {
+    if (!built_) return false;
+    ofstream f(filename, ios::binary);
+    if (!f.is_open()) return false;
+
+    writePod(f, FILE_MAGIC);
+    writePod(f, FILE_FORMAT);
+    writePod(f, numNodes_);
+    writePod(f, fingerprint_);
+    writePod(f, static_cast<uint64_t>(numEntries_));
+    for (const LabelSet* s : {&forward_, &backward_}) {
+        writePod(f, static_cast<uint64_t>(s->hubs.size()));
+        writeArray(f, s->first);
+        writeArray(f, s->hubs);
+        writeArray(f, s->dists);
+    }
+    return static_cast<bool>(f);
+}
+
+/**
+ * @brief Kiểm tra cấu trúc một bộ nhãn vừa đọc trước khi merge() được phép chạy
+ *        trên nó: first bắt đầu từ 0 và mỗi nhãn có ít nhất một mục, mục cuối của
+ *        mỗi nhãn là SENTINEL (vòng trộn dừng nhờ nó), các hub trước lính canh nhỏ
+ *        hơn n và tăng ngặt. Cộng số mục thật vào entries.
+ */
+bool HubLabels::validLabels(const LabelSet& s, uint32_t n, uint64_t& entries) {
+    if (s.first[0] != 0) return false;
+    for (uint32_t v = 0; v < n; v++) {
+        uint32_t a = s.first[v], b = s.first[v + 1];
+        if (b <= a || s.hubs[b - 1] != SENTINEL) return false;
+        uint32_t i = a;
+        for (; s.hubs[i] != SENTINEL; i++) {
+            if (s.hubs[i] >= n || (i > a && s.hubs[i] <= s.hubs[i - 1])) return false;
+        }
+        entries += i - a;
+    }
+    return true;
+}
+
+/**
+ * @brief Nạp nhãn từ tệp; chỉ nhận khi tệp được dựng cho đúng đồ thị g.
+ *        Nếu thất bại, nhãn hiện có được giữ nguyên.
+ */
+bool HubLabels::load(const string& filename, const CompactGraph& g) {
+    ifstream f(filename, ios::binary);
+    if (!f.is_open()) return false;
+
+    uint32_t magic = 0, format = 0, n = 0;
+    uint64_t fingerprint = 0, entries = 0;
+    if (!readPod(f, magic) || magic != FILE_MAGIC) return false;
+    if (!readPod(f, format) || format != FILE_FORMAT) return false;
+    if (!readPod(f, n) || n != g.numNodes()) return false;
+    if (!readPod(f, fingerprint) || fingerprint != graphFingerprint(g)) return false;
+    if (!readPod(f, entries)) return false;
+
+    LabelSet sets[2];
+    uint64_t counted = 0;
+    for (LabelSet& s : sets) {
+        uint64_t size = 0;
+        if (!readPod(f, size)) return false;
+        if (!readArray(f, s.first, uint64_t(n) + 1) || s.first[n] != size) return false;
+        if (!readArray(f, s.hubs, size) || !readArray(f, s.dists, size)) return false;
+        if (!validLabels(s, n, counted)) return false;
+    }
+    if (counted != entries) return false;
+
+    forward_ = std::move(sets[0]);
+    backward_ = std::move(sets[1]);
+    numNodes_ = n;
+    numEntries_ = entries;
+    fingerprint_ = fingerprint;
+    version_ = g.version;
+    weightVersion_ = g.weightVersion;
+    built_ = true;
+    return true;
+}
+
+bool HubLabels::loadOrBuild(const string& mapFile, const CompactGraph& g, unsigned threads) {
+    if (load(fileFor(mapFile), g)) return true;
+    build(g, threads);
+    save(fileFor(mapFile));
+    return false;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "CompactGraph.h"
+#include "ContractionHierarchy.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <string>
+#include <vector>
+
+// Cấp phát căn lề theo dòng cache cho mảng nhãn
+template <class T, size_t Align = 64>
+struct CacheAlignedAllocator {
+    using value_type = T;
+    template <class U> struct rebind { using other = CacheAlignedAllocator<U, Align>; };
+
+    CacheAlignedAllocator() = default;
+    template <class U> CacheAlignedAllocator(const CacheAlignedAllocator<U, Align>&) {}
+
+    T* allocate(size_t n) {
+        size_t bytes = (n * sizeof(T) + Align - 1) / Align * Align;
+        void* p = std::aligned_alloc(Align, bytes ? bytes : Align);
+        if (!p) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+    void deallocate(T* p, size_t) { std::free(p); }
+
+    template <class U> bool operator==(const CacheAlignedAllocator<U, Align>&) const { return true; }
+    template <class U> bool operator!=(const CacheAlignedAllocator<U, Align>&) const { return false; }
+};
+
+// Hub labeling: mỗi node v có nhãn xuôi Lf(v) = {(h, d(v,h))} và nhãn ngược
+// Lb(v) = {(h, d(h,v))}, sao cho d(s,t) = min trên hub chung của Lf(s) và Lb(t).
+// Nhãn lấy từ không gian tìm kiếm hướng lên của Contraction Hierarchy rồi tỉa các
+// mục bị trội. Hub được lưu theo hạng trong phân cấp nên mỗi nhãn đã sắp tăng dần
+// và truy vấn chỉ là trộn hai dãy ngắn. Mỗi nhãn bắt đầu ở đầu một dòng cache và
+// kết thúc bằng hub lính canh SENTINEL (lớn hơn mọi hạng), nên vòng trộn không cần
+// kiểm tra biên. Chỉ trả khoảng cách (không có đường đi); giống CH, nhãn dựng với
+// weight tại thời điểm build và bỏ qua trạng thái chặn.
+class HubLabels {
+public:
+    // Dựng trên phân cấp có sẵn (phải khớp với g)
+    void build(const CompactGraph& g, const ContractionHierarchy& ch, unsigned threads = 0);
+    // Tự dựng phân cấp tạm rồi lấy nhãn
+    void build(const CompactGraph& g, unsigned threads = 0);
+
+    bool isValidFor(const CompactGraph& g) const {
+        return built_ && version_ == g.version && weightVersion_ == g.weightVersion;
+    }
+
+    // d(source, target), hoặc -1 nếu không có đường
+    double distance(uint32_t source, uint32_t target) const;
+
+    uint32_t numNodes() const { return numNodes_; }
+    // Tổng số mục nhãn (không tính phần đệm)
+    size_t numEntries() const { return numEntries_; }
+    double averageLabelSize() const {
+        return numNodes_ ? static_cast<double>(numEntries_) / (2.0 * numNodes_) : 0;
+    }
+
+    // Lưu / nạp dạng nhị phân. Tệp mang dấu vân tay của topology và weight; load()
+    // từ chối tệp dựng cho bản đồ khác hoặc weight khác, và tệp có nhãn hỏng (first
+    // giảm, hub ngoài phạm vi hoặc không tăng dần, nhãn thiếu SENTINEL ở cuối).
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename, const CompactGraph& g);
+
+    // Tệp nhãn đi kèm một tệp bản đồ: "<mapFile>.hl"
+    static std::string fileFor(const std::string& mapFile) { return mapFile + ".hl"; }
+    // Nạp từ fileFor(mapFile) nếu còn khớp với g, nếu không thì dựng lại và ghi đè
+    // tệp. Trả về true nếu nhãn được nạp từ tệp (không phải dựng lại).
+    bool loadOrBuild(const std::string& mapFile, const CompactGraph& g, unsigned threads = 0);
+
+private:
+    static constexpr uint32_t SENTINEL = 0xFFFFFFFFu;
+    // Số mục trên một dòng cache 64 byte của mảng hub
+    static constexpr uint32_t ENTRIES_PER_LINE = 16;
+
+    using HubArray = std::vector<uint32_t, CacheAlignedAllocator<uint32_t>>;
+    using DistArray = std::vector<double, CacheAlignedAllocator<double>>;
+
+    // Nhãn của node v là [first[v], first[v+1]); mục cuối cùng có hub = SENTINEL
+    struct LabelSet {
+        std::vector<uint32_t> first;
+        HubArray hubs;
+        DistArray dists;
+    };
+
+    bool built_ = false;
+    uint64_t version_ = 0;
+    uint64_t weightVersion_ = 0;
+    uint64_t fingerprint_ = 0;
+    uint32_t numNodes_ = 0;
+    size_t numEntries_ = 0;
+
+    LabelSet forward_;
+    LabelSet backward_;
+
+    static bool validLabels(const LabelSet& s, uint32_t n, uint64_t& entries);
+    static double merge(const uint32_t* h1, const double* d1, const uint32_t* h2, const double* d2);
+};
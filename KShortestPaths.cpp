@@ -0,0 +1,225 @@
+#include "KShortestPaths.h"
+#include "SearchWorkspace.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <set>
+#include <utility>
+
+using namespace std;
+
+namespace {
+    const double INF = numeric_limits<double>::infinity();
+    const uint32_t NONE = CompactGraph::INVALID;
+
+    // Lớp phủ cấm theo tem của từng luồng: ô bằng tem hiện tại nghĩa là bị cấm
+    struct Overlay {
+        vector<uint32_t> node;
+        vector<uint32_t> edge;
+        vector<uint32_t> onPath;    // node trên đoạn nhánh đang xét (chống lặp)
+        uint32_t stamp = 0;
+        uint32_t pathStamp = 0;
+
+        void reset(uint32_t n, uint32_t m) {
+            if (node.size() < n) {
+                node.assign(n, 0);
+                onPath.assign(n, 0);
+            }
+            if (edge.size() < m) edge.assign(m, 0);
+            if (++stamp == 0) {
+                fill(node.begin(), node.end(), 0);
+                fill(edge.begin(), edge.end(), 0);
+                stamp = 1;
+            }
+        }
+    };
+
+    Overlay& overlayForThread() {
+        thread_local Overlay overlay;
+        return overlay;
+    }
+
+    EdgeRoute makeRoute(const CompactGraph& g, uint32_t source, const vector<uint32_t>& edges) {
+        EdgeRoute r;
+        r.source = source;
+        double time = 0;
+        for (uint32_t e : edges) {
+            time += g.weight[e];
+            r.steps.push_back({e, time});
+        }
+        r.cost = time;
+        return r;
+    }
+}
+
+KShortestPaths::KShortestPaths(RoadMap& map) : map_(map) {}
+
+vector<EdgeRoute> KShortestPaths::find(const string& start, const string& goal, size_t k) {
+    const CompactGraph& g = map_.graph();
+    uint32_t s = g.findNode(start);
+    uint32_t t = g.findNode(goal);
+    if (s == CompactGraph::INVALID || t == CompactGraph::INVALID) return {};
+    return find(s, t, k);
+}
+
+/**
+ * @brief Dijkstra ngược từ đích trên Edge không bị chặn.
+ */
+void KShortestPaths::buildReverseTree(const CompactGraph& g, uint32_t target) {
+    toGoal_.assign(g.numNodes(), INF);
+    treeNext_.assign(g.numNodes(), NONE);
+
+    SearchWorkspace& ws = SearchWorkspace::forThread();
+    ws.reset(g.numNodes());
+    ws.set(target, 0, NONE);
+    ws.push(0, target);
+    while (!ws.empty()) {
+        auto [d, v] = ws.pop();
+        if (d > ws.dist(v)) continue;
+        toGoal_[v] = d;
+        treeNext_[v] = ws.parent(v);
+        for (ArcView arc : g.inArcs(v)) {
+            double nd = d + arc.weight;
+            if (nd < ws.dist(arc.target)) {
+                ws.set(arc.target, nd, arc.edge);
+                ws.push(nd, arc.target);
+            }
+        }
+    }
+}
+
+/**
+ * @brief A* từ spur tới đích với h = toGoal_ (chính xác trên đồ thị gốc nên nhất
+ *        quán trên đồ thị đã cấm bớt). Khi lấy ra u mà đường cây từ u không đụng
+ *        node/Edge cấm và không quay lại đoạn spur -> u, chi phí g(u) + h(u) là tối
+ *        ưu nên dừng luôn.
+ */
+double KShortestPaths::spurSearch(const CompactGraph& g, uint32_t spur, uint32_t target,
+                                  const vector<uint32_t>& bannedNodes,
+                                  const vector<uint32_t>& bannedEdges,
+                                  vector<uint32_t>& outEdges) const {
+    Overlay& ov = overlayForThread();
+    ov.reset(g.numNodes(), g.numEdges());
+    for (uint32_t v : bannedNodes) ov.node[v] = ov.stamp;
+    for (uint32_t e : bannedEdges) ov.edge[e] = ov.stamp;
+
+    auto treePathValid = [&](uint32_t u, uint32_t parentEdge, const SearchWorkspace& ws) {
+        if (++ov.pathStamp == 0) {
+            fill(ov.onPath.begin(), ov.onPath.end(), 0);
+            ov.pathStamp = 1;
+        }
+        for (uint32_t v = u, e = parentEdge;; v = g.tail[e], e = ws.parent(v)) {
+            ov.onPath[v] = ov.pathStamp;
+            if (e == NONE) break;
+        }
+        for (uint32_t v = u; v != target;) {
+            uint32_t e = treeNext_[v];
+            if (ov.edge[e] == ov.stamp) return false;
+            v = g.head[e];
+            if (ov.node[v] == ov.stamp || ov.onPath[v] == ov.pathStamp) return false;
+        }
+        return true;
+    };
+
+    SearchWorkspace& ws = SearchWorkspace::forThread();
+    ws.reset(g.numNodes());
+    ws.set(spur, 0, NONE);
+    ws.push(toGoal_[spur], spur);
+
+    while (!ws.empty()) {
+        auto [f, u] = ws.pop();
+        double d = ws.dist(u);
+        if (f > d + toGoal_[u]) continue;
+
+        if (treePathValid(u, ws.parent(u), ws)) {
+            for (uint32_t v = u; v != spur; v = g.tail[ws.parent(v)]) outEdges.push_back(ws.parent(v));
+            reverse(outEdges.begin(), outEdges.end());
+            for (uint32_t v = u; v != target; v = g.head[treeNext_[v]]) outEdges.push_back(treeNext_[v]);
+            return d + toGoal_[u];
+        }
+
+        for (ArcView arc : g.outArcs(u)) {
+            if (ov.edge[arc.edge] == ov.stamp || ov.node[arc.target] == ov.stamp) continue;
+            if (toGoal_[arc.target] == INF) continue;
+            double nd = d + arc.weight;
+            if (nd < ws.dist(arc.target)) {
+                ws.set(arc.target, nd, arc.edge);
+                ws.push(nd + toGoal_[arc.target], arc.target);
+            }
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Yen: tuyến thứ i+1 là ứng viên rẻ nhất sinh từ tuyến thứ i. Với mỗi node
+ *        spur v_j của tuyến i, đoạn gốc v_0..v_j giữ nguyên; cấm v_0..v_{j-1} (để
+ *        không lặp) và Edge tiếp theo sau đoạn gốc của mọi tuyến đã chọn có cùng
+ *        đoạn gốc, rồi tìm nhánh ngắn nhất từ v_j tới đích.
+ */
+vector<EdgeRoute> KShortestPaths::find(uint32_t source, uint32_t target, size_t k) {
+    const CompactGraph& g = map_.graph();
+    vector<EdgeRoute> routes;
+    if (source >= g.numNodes() || target >= g.numNodes() || k == 0) return routes;
+
+    buildReverseTree(g, target);
+    if (toGoal_[source] == INF) return routes;
+
+    vector<vector<uint32_t>> accepted(1);
+    for (uint32_t v = source; v != target; v = g.head[treeNext_[v]]) accepted[0].push_back(treeNext_[v]);
+
+    // Ứng viên: (chi phí, chỉ số trong pool); seen chặn ứng viên trùng
+    using Candidate = pair<double, size_t>;
+    priority_queue<Candidate, vector<Candidate>, greater<Candidate>> heap;
+    vector<vector<uint32_t>> pool;
+    set<vector<uint32_t>> seen{accepted[0]};
+    const unsigned threads = defaultThreadCount(threads_);
+    if (threads > 1 && (!pool_ || pool_->size() != threads)) pool_.reset(new ThreadPool(threads));
+
+    while (accepted.size() < k) {
+        const vector<uint32_t>& prev = accepted.back();
+        vector<uint32_t> nodes{source};
+        vector<double> rootCost{0};
+        for (uint32_t e : prev) {
+            nodes.push_back(g.head[e]);
+            rootCost.push_back(rootCost.back() + g.weight[e]);
+        }
+
+        vector<vector<uint32_t>> found(prev.size());
+        vector<double> foundCost(prev.size(), -1);
+        auto spur = [&](size_t j) {
+            vector<uint32_t> bannedNodes(nodes.begin(), nodes.begin() + j);
+            vector<uint32_t> bannedEdges;
+            for (const auto& p : accepted)
+                if (p.size() > j && equal(prev.begin(), prev.begin() + j, p.begin()))
+                    bannedEdges.push_back(p[j]);
+
+            vector<uint32_t> spurEdges;
+            double c = spurSearch(g, nodes[j], target, bannedNodes, bannedEdges, spurEdges);
+            if (c < 0) return;
+            found[j].assign(prev.begin(), prev.begin() + j);
+            found[j].insert(found[j].end(), spurEdges.begin(), spurEdges.end());
+            foundCost[j] = rootCost[j] + c;
+        };
+        if (threads == 1 || prev.size() < 2) {
+            for (size_t j = 0; j < prev.size(); j++) spur(j);
+        } else {
+            for (size_t j = 0; j < prev.size(); j++) pool_->submit([&spur, j] { spur(j); });
+            pool_->wait();
+        }
+
+        for (size_t j = 0; j < prev.size(); j++) {
+            if (foundCost[j] < 0 || !seen.insert(found[j]).second) continue;
+            heap.push({foundCost[j], pool.size()});
+            pool.push_back(std::move(found[j]));
+        }
+        if (heap.empty()) break;
+        accepted.push_back(std::move(pool[heap.top().second]));
+        heap.pop();
+    }
+
+    for (const auto& edges : accepted) routes.push_back(makeRoute(g, source, edges));
+    return routes;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "RoadMap.h"
+#include "ShortestPath.h"
+#include "ThreadPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// K đường ngắn nhất không lặp node (thuật toán Yen) theo thời gian đi.
+// Cây đường ngắn nhất ngược tới đích được tính một lần cho mỗi truy vấn và dùng
+// lại cho mọi tìm kiếm nhánh (spur): khoảng cách tới đích trên cây là heuristic
+// A* chính xác trên đồ thị gốc, và nhánh dừng ngay khi gặp node mà đường trên cây
+// tới đích không đụng node/Edge bị cấm. Các tìm kiếm nhánh từ các node của đường
+// trước chạy song song trên thread pool của đối tượng (tạo ở lần cần đầu tiên), nên
+// lớp phủ và workspace của mỗi luồng được dùng lại qua mọi vòng lặp và mọi truy vấn.
+// Node/Edge bị cấm của mỗi tìm kiếm nằm trong lớp phủ riêng của luồng, không
+// chặn/bỏ chặn trên RoadMap dùng chung. Edge đang bị chặn trên bản
+// đồ vẫn bị bỏ qua; chi phí rẽ không được tính.
+class KShortestPaths {
+public:
+    KShortestPaths(RoadMap& map);
+
+    // threads = 0: dùng std::thread::hardware_concurrency()
+    void setThreads(unsigned threads) { threads_ = threads; }
+
+    // Tối đa k tuyến khác nhau theo thời gian tăng dần; rỗng nếu không có đường
+    std::vector<EdgeRoute> find(const std::string& start, const std::string& goal, size_t k);
+    std::vector<EdgeRoute> find(uint32_t source, uint32_t target, size_t k);
+
+private:
+    RoadMap& map_;
+    unsigned threads_ = 0;
+    std::unique_ptr<ThreadPool> pool_;
+
+    // Cây ngược tới đích của truy vấn hiện tại
+    std::vector<double> toGoal_;        // d(v, đích), vô cực nếu không tới được
+    std::vector<uint32_t> treeNext_;    // Edge đầu tiên trên đường cây từ v
+
+    void buildReverseTree(const CompactGraph& g, uint32_t target);
+    double spurSearch(const CompactGraph& g, uint32_t spur, uint32_t target,
+                      const std::vector<uint32_t>& bannedNodes,
+                      const std::vector<uint32_t>& bannedEdges,
+                      std::vector<uint32_t>& outEdges) const;
+};
@@ -0,0 +1,103 @@
+#include "Landmarks.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+using namespace std;
+
+namespace {
+    const double INF = numeric_limits<double>::infinity();
+
+    /**
+     * @brief Dijkstra một-tới-tất-cả từ các nguồn cho trước, bỏ qua trạng thái chặn.
+     *        backward = true: đi ngược trên inEdge, cho ra d(v, nguồn).
+     */
+    void oneToAll(const CompactGraph& g, const vector<uint32_t>& sources,
+                  bool backward, vector<double>& dist) {
+        dist.assign(g.numNodes(), INF);
+        vector<pair<double, uint32_t>> heap;
+        auto cmp = greater<pair<double, uint32_t>>();
+        for (uint32_t s : sources) {
+            dist[s] = 0;
+            heap.push_back({0, s});
+        }
+
+        while (!heap.empty()) {
+            pop_heap(heap.begin(), heap.end(), cmp);
+            auto [d, u] = heap.back();
+            heap.pop_back();
+            if (d > dist[u]) continue;
+
+            uint32_t first = backward ? g.firstIn[u] : g.firstOut[u];
+            uint32_t last = backward ? g.firstIn[u + 1] : g.firstOut[u + 1];
+            for (uint32_t i = first; i < last; i++) {
+                uint32_t a = backward ? g.inEdge[i] : i;
+                uint32_t v = backward ? g.tail[a] : g.head[a];
+                double nd = d + g.weight[a];
+                if (nd < dist[v]) {
+                    dist[v] = nd;
+                    heap.push_back({nd, v});
+                    push_heap(heap.begin(), heap.end(), cmp);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Chọn landmark "xa nhất" và tính bảng khoảng cách.
+ *        Landmark đầu tiên là node xa nhất tính từ node 0; mỗi landmark tiếp theo
+ *        là node có khoảng cách (theo cả hai chiều) lớn nhất tới tập đã chọn, ưu tiên
+ *        node chưa tới được để phủ mọi thành phần liên thông. Bảng khoảng cách của
+ *        các landmark được tính song song, mỗi luồng nhận lần lượt một landmark.
+ */
+void LandmarkIndex::build(const CompactGraph& g, unsigned k, unsigned threads) {
+    const uint32_t n = g.numNodes();
+    k_ = 0;
+    landmarks_.clear();
+    fromL_.clear();
+    toL_.clear();
+    if (n == 0 || k == 0) return;
+    k = min<unsigned>(k, n);
+
+    // 1. Chọn landmark (tuần tự: mỗi lựa chọn phụ thuộc các lựa chọn trước)
+    vector<double> fwd, bwd;
+    vector<uint32_t> seed{0};
+    while (landmarks_.size() < k) {
+        const vector<uint32_t>& from = landmarks_.empty() ? seed : landmarks_;
+        oneToAll(g, from, false, fwd);
+        oneToAll(g, from, true, bwd);
+
+        uint32_t best = CompactGraph::INVALID;
+        double bestScore = -1;
+        for (uint32_t v = 0; v < n; v++) {
+            if (find(landmarks_.begin(), landmarks_.end(), v) != landmarks_.end()) continue;
+            double score = min(fwd[v], bwd[v]);
+            if (score == INF) score = numeric_limits<double>::max();
+            if (score > bestScore) {
+                bestScore = score;
+                best = v;
+            }
+        }
+        if (best == CompactGraph::INVALID) break;
+        landmarks_.push_back(best);
+    }
+    k_ = static_cast<unsigned>(landmarks_.size());
+
+    // 2. Bảng khoảng cách, song song theo landmark
+    fromL_.assign(static_cast<size_t>(n) * k_, INF);
+    toL_.assign(static_cast<size_t>(n) * k_, INF);
+
+    parallelFor(k_, defaultThreadCount(threads), [&](size_t i) {
+        vector<double> dist;
+        vector<uint32_t> src{landmarks_[i]};
+        oneToAll(g, src, false, dist);
+        for (uint32_t v = 0; v < n; v++) fromL_[static_cast<size_t>(v) * k_ + i] = dist[v];
+        oneToAll(g, src, true, dist);
+        for (uint32_t v = 0; v < n; v++) toL_[static_cast<size_t>(v) * k_ + i] = dist[v];
+    }, 1);
+
+    version_ = g.version;
+    decreaseVersion_ = g.decreaseVersion;
+}
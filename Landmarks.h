@@ -0,0 +1,47 @@
+#pragma once
+#include "CompactGraph.h"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Tiền xử lý ALT (A*, Landmarks, Triangle inequality).
+// Chọn k landmark bằng chiến lược "xa nhất" rồi lưu bảng khoảng cách xuôi
+// d(L, v) và ngược d(v, L) cho mọi node. Bảng được tính trên đồ thị không chặn
+// Edge nào: chặn Edge chỉ làm khoảng cách tăng nên cận dưới vẫn hợp lệ.
+class LandmarkIndex {
+public:
+    // threads = 0: dùng std::thread::hardware_concurrency()
+    void build(const CompactGraph& g, unsigned k, unsigned threads = 0);
+
+    // Tăng weight không làm hỏng cận dưới, chỉ giảm weight mới cần tính lại
+    bool isValidFor(const CompactGraph& g) const {
+        return k_ > 0 && version_ == g.version && decreaseVersion_ == g.decreaseVersion;
+    }
+    unsigned size() const { return k_; }
+    const std::vector<uint32_t>& landmarks() const { return landmarks_; }
+
+    // Cận dưới của d(v, t): max_L max(d(L,t) - d(L,v), d(v,L) - d(t,L))
+    double lowerBound(uint32_t v, uint32_t t) const {
+        const double* fv = &fromL_[static_cast<size_t>(v) * k_];
+        const double* tv = &toL_[static_cast<size_t>(v) * k_];
+        const double* ft = &fromL_[static_cast<size_t>(t) * k_];
+        const double* tt = &toL_[static_cast<size_t>(t) * k_];
+        double best = 0;
+        for (unsigned i = 0; i < k_; i++) {
+            // bỏ qua các cặp có khoảng cách vô hạn (không liên thông)
+            if (ft[i] < INF && fv[i] < INF && ft[i] - fv[i] > best) best = ft[i] - fv[i];
+            if (tv[i] < INF && tt[i] < INF && tv[i] - tt[i] > best) best = tv[i] - tt[i];
+        }
+        return best;
+    }
+
+private:
+    static constexpr double INF = std::numeric_limits<double>::infinity();
+
+    unsigned k_ = 0;
+    uint64_t version_ = 0;
+    uint64_t decreaseVersion_ = 0;
+    std::vector<uint32_t> landmarks_;
+    std::vector<double> fromL_;     // [v * k + i] = d(L_i, v)
+    std::vector<double> toL_;       // [v * k + i] = d(v, L_i)
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include "CompactGraph.h"
+#include "RoadMap.h"
+#include <cstdint>
+#include <limits>
+#include <string>
+
+// Hàm chi phí dạng policy cho tìm kiếm: mỗi policy là một struct với hàm tĩnh
+// cost(g, arc), được truyền làm tham số template nên vòng lặp tìm kiếm được biên
+// dịch riêng cho từng hàm chi phí, không rẽ nhánh hay gọi ảo trên mỗi cung.
+// Chi phí vô hạn nghĩa là không được đi qua Edge đó.
+
+// Thời gian đi (Edge::travelTime(), giờ) - mặc định
+struct TravelTimeMetric {
+    static double cost(const CompactGraph&, const ArcView& arc) { return arc.weight; }
+};
+
+// Thời gian đi có tính ùn tắc theo BPR (CompactGraph::congestedWeight)
+struct CongestedTimeMetric {
+    static double cost(const CompactGraph& g, const ArcView& arc) { return g.congestedWeight[arc.edge]; }
+};
+
+// Quãng đường ngắn nhất (Edge::length, km)
+struct DistanceMetric {
+    static double cost(const CompactGraph& g, const ArcView& arc) { return g.length[arc.edge]; }
+};
+
+// Tổng chi phí Edge::budget
+struct BudgetMetric {
+    static double cost(const CompactGraph& g, const ArcView& arc) { return g.budget[arc.edge]; }
+};
+
+constexpr uint8_t roadTypeBit(RoadType t) { return static_cast<uint8_t>(1u << static_cast<unsigned>(t)); }
+
+// Thời gian đi, nhưng không đi qua các loại đường trong AvoidMask (bit theo RoadType)
+template <uint8_t AvoidMask>
+struct AvoidRoadTypesMetric {
+    static double cost(const CompactGraph& g, const ArcView& arc) {
+        return (AvoidMask >> g.roadType[arc.edge]) & 1u
+            ? std::numeric_limits<double>::infinity() : arc.weight;
+    }
+};
+
+// Các hàm chi phí được biên dịch sẵn, chọn lúc chạy theo tên
+enum class MetricKind {
+    TRAVEL_TIME,            // "time"
+    DISTANCE,               // "distance"
+    BUDGET,                 // "budget"
+    AVOID_HIGHWAY,          // "avoid_highway"
+    AVOID_BRIDGE,           // "avoid_bridge"
+    AVOID_TUNNEL,           // "avoid_tunnel"
+    AVOID_BRIDGE_TUNNEL,    // "avoid_bridge_tunnel"
+    CONGESTED_TIME          // "congested"
+};
+
+using AvoidHighwayMetric = AvoidRoadTypesMetric<roadTypeBit(RoadType::HIGHWAY)>;
+using AvoidBridgeMetric = AvoidRoadTypesMetric<roadTypeBit(RoadType::BRIDGE)>;
+using AvoidTunnelMetric = AvoidRoadTypesMetric<roadTypeBit(RoadType::TUNNEL)>;
+using AvoidBridgeTunnelMetric =
+    AvoidRoadTypesMetric<roadTypeBit(RoadType::BRIDGE) | roadTypeBit(RoadType::TUNNEL)>;
+
+inline const char* metricName(MetricKind kind) {
+    switch (kind) {
+    case MetricKind::DISTANCE: return "distance";
+    case MetricKind::BUDGET: return "budget";
+    case MetricKind::AVOID_HIGHWAY: return "avoid_highway";
+    case MetricKind::AVOID_BRIDGE: return "avoid_bridge";
+    case MetricKind::AVOID_TUNNEL: return "avoid_tunnel";
+    case MetricKind::AVOID_BRIDGE_TUNNEL: return "avoid_bridge_tunnel";
+    case MetricKind::CONGESTED_TIME: return "congested";
+    case MetricKind::TRAVEL_TIME:
+    default: return "time";
+    }
+}
+
+// Trả về false nếu tên không có trong danh sách
+inline bool metricFromName(const std::string& name, MetricKind& out) {
+    const MetricKind all[] = {MetricKind::TRAVEL_TIME, MetricKind::DISTANCE, MetricKind::BUDGET,
+                              MetricKind::AVOID_HIGHWAY, MetricKind::AVOID_BRIDGE,
+                              MetricKind::AVOID_TUNNEL, MetricKind::AVOID_BRIDGE_TUNNEL,
+                              MetricKind::CONGESTED_TIME};
+    for (MetricKind k : all) {
+        if (name == metricName(k)) {
+            out = k;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Số luồng mặc định khi người gọi truyền 0
+inline unsigned defaultThreadCount(unsigned threads) {
+    return threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Chạy fn(i) cho i trong [0, count) trên tối đa `threads` luồng (tính cả luồng gọi).
+// Các luồng nhận lần lượt từng khối `chunk` chỉ số qua một bộ đếm nguyên tử.
+template <class F>
+void parallelFor(size_t count, unsigned threads, F fn, size_t chunk = 64) {
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t b = next.fetch_add(chunk); b < count; b = next.fetch_add(chunk))
+            for (size_t i = b; i < std::min(count, b + chunk); i++) fn(i);
+    };
+    unsigned used = static_cast<unsigned>(std::min<size_t>(threads, (count + chunk - 1) / chunk));
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < used; t++) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+}
@@ -0,0 +1,158 @@
+#include "ParetoRoute.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <tuple>
+#include <utility>
+
+using namespace std;
+
+namespace {
+    const double INF = numeric_limits<double>::infinity();
+
+    // Chi phí của một cung theo từng tiêu chí, cùng thứ tự với Label::cost
+    inline void arcCosts(const CompactGraph& g, const ArcView& arc, double* out) {
+        out[0] = TravelTimeMetric::cost(g, arc);
+        out[1] = DistanceMetric::cost(g, arc);
+        out[2] = BudgetMetric::cost(g, arc);
+    }
+
+    // a trội b: không tệ hơn ở mọi tiêu chí (nhãn trùng chi phí cũng bị bỏ)
+    inline bool dominates(const double* a, const double* b) {
+        return a[0] <= b[0] && a[1] <= b[1] && a[2] <= b[2];
+    }
+}
+
+ParetoRoute::ParetoRoute(RoadMap& map) : map_(map) {}
+
+vector<ParetoRouteResult> ParetoRoute::findParetoRoutes(const string& start, const string& goal) {
+    const CompactGraph& g = map_.graph();
+    uint32_t s = g.findNode(start);
+    uint32_t t = g.findNode(goal);
+    if (s == CompactGraph::INVALID || t == CompactGraph::INVALID) return {};
+    return findParetoRoutes(s, t);
+}
+
+/**
+ * @brief Dijkstra ngược từ đích cho từng tiêu chí; bound_[k][v] = chi phí nhỏ nhất
+ *        theo tiêu chí k từ v tới đích (vô hạn nếu không tới được).
+ */
+void ParetoRoute::computeBounds(const CompactGraph& g, uint32_t target) {
+    using Entry = pair<double, uint32_t>;
+    const uint32_t n = g.numNodes();
+    for (int k = 0; k < CRITERIA; k++) {
+        vector<double>& dist = bound_[k];
+        dist.assign(n, INF);
+        priority_queue<Entry, vector<Entry>, greater<Entry>> pq;
+        dist[target] = 0;
+        pq.push({0, target});
+        while (!pq.empty()) {
+            auto [d, v] = pq.top();
+            pq.pop();
+            if (d > dist[v]) continue;
+            for (ArcView arc : g.inArcs(v)) {
+                double c[CRITERIA];
+                arcCosts(g, arc, c);
+                double nd = d + c[k];
+                if (nd < dist[arc.target]) {
+                    dist[arc.target] = nd;
+                    pq.push({nd, arc.target});
+                }
+            }
+        }
+    }
+}
+
+bool ParetoRoute::dominatedByBag(const vector<uint32_t>& bag, const double* cost) const {
+    for (uint32_t i : bag)
+        if (dominates(labels_[i].cost, cost)) return true;
+    return false;
+}
+
+/**
+ * @brief Label-setting đa tiêu chí. Nhãn mới tại w bị bỏ nếu túi của w trội nó,
+ *        hoặc nếu chi phí cộng cận dưới tới đích đã bị túi của đích trội; ngược
+ *        lại nó đẩy các nhãn bị nó trội ra khỏi túi của w.
+ */
+vector<ParetoRouteResult> ParetoRoute::findParetoRoutes(uint32_t source, uint32_t target) {
+    const CompactGraph& g = map_.graph();
+    const uint32_t n = g.numNodes();
+    truncated_ = false;
+    if (source >= n || target >= n) return {};
+
+    if (bags_.size() < n) bags_.resize(n);
+    for (uint32_t v : touched_) bags_[v].clear();
+    touched_.clear();
+    labels_.clear();
+
+    computeBounds(g, target);
+    if (bound_[0][source] == INF) return {};
+
+    // (thời gian, quãng đường, budget, chỉ số nhãn) - lấy ra theo thứ tự từ điển
+    using Entry = tuple<double, double, double, uint32_t>;
+    priority_queue<Entry, vector<Entry>, greater<Entry>> pq;
+
+    labels_.push_back({{0, 0, 0}, source, NONE, false});
+    bags_[source].push_back(0);
+    touched_.push_back(source);
+    pq.push({0, 0, 0, 0});
+
+    while (!pq.empty()) {
+        uint32_t li = get<3>(pq.top());
+        pq.pop();
+        if (labels_[li].dead) continue;
+        uint32_t v = labels_[li].node;
+        if (v == target) continue;
+
+        if (maxLabels_ && labels_.size() >= maxLabels_) {
+            truncated_ = true;
+            break;
+        }
+
+        for (ArcView arc : g.outArcs(v)) {
+            uint32_t w = arc.target;
+            if (bound_[0][w] == INF) continue;
+
+            double c[CRITERIA], lb[CRITERIA];
+            arcCosts(g, arc, c);
+            for (int k = 0; k < CRITERIA; k++) {
+                c[k] += labels_[li].cost[k];
+                lb[k] = c[k] + bound_[k][w];
+            }
+            if (dominatedByBag(bags_[target], lb) || dominatedByBag(bags_[w], c)) continue;
+
+            vector<uint32_t>& bag = bags_[w];
+            if (bag.empty()) touched_.push_back(w);
+            size_t keep = 0;
+            for (uint32_t i : bag) {
+                if (dominates(c, labels_[i].cost)) labels_[i].dead = true;
+                else bag[keep++] = i;
+            }
+            bag.resize(keep);
+
+            uint32_t ni = static_cast<uint32_t>(labels_.size());
+            labels_.push_back({{c[0], c[1], c[2]}, w, li, false});
+            bag.push_back(ni);
+            pq.push({c[0], c[1], c[2], ni});
+        }
+    }
+
+    vector<ParetoRouteResult> front;
+    for (uint32_t i : bags_[target]) {
+        ParetoRouteResult r;
+        r.success = true;
+        r.travelTime = labels_[i].cost[0];
+        r.distance = labels_[i].cost[1];
+        r.budget = labels_[i].cost[2];
+        for (uint32_t l = i; l != NONE; l = labels_[l].parent)
+            r.path.push_back(g.nodeIds[labels_[l].node]);
+        reverse(r.path.begin(), r.path.end());
+        front.push_back(std::move(r));
+    }
+    sort(front.begin(), front.end(), [](const ParetoRouteResult& a, const ParetoRouteResult& b) {
+        return tie(a.travelTime, a.distance, a.budget) < tie(b.travelTime, b.distance, b.budget);
+    });
+    return front;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "RoadMap.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Một tuyến trên mặt Pareto: không tuyến nào khác tốt hơn hoặc bằng nó ở cả ba tiêu chí
+struct ParetoRouteResult {
+    bool success;
+    std::vector<std::string> path;
+    double travelTime;      // giờ
+    double distance;        // km
+    double budget;          // tổng Edge::budget
+    std::string errorMessage;
+};
+
+// Tìm đường đa tiêu chí (thời gian, quãng đường, chi phí budget) kiểu label-setting
+// (Martins): mỗi node giữ một túi nhãn không bị trội nhau, nhãn được lấy ra theo thứ
+// tự từ điển (thời gian, quãng đường, budget) nên nhãn đã lấy ra là tối ưu Pareto.
+// Cận dưới của từng tiêu chí tới đích (ba Dijkstra ngược) dùng để bỏ nhãn mà mọi
+// phần kéo dài đều bị một tuyến đã tới đích trội hơn. Nhãn nằm trong vùng nhớ gom
+// (arena) dùng lại giữa các truy vấn; nhãn trỏ về nhãn cha bằng chỉ số.
+class ParetoRoute {
+public:
+    ParetoRoute(RoadMap& map);
+
+    // Dừng khi số nhãn vượt ngưỡng (0 = không giới hạn); mặt Pareto khi đó có thể thiếu
+    void setMaxLabels(size_t maxLabels) { maxLabels_ = maxLabels; }
+    // Lần tìm gần nhất có bị dừng vì setMaxLabels không
+    bool truncated() const { return truncated_; }
+
+    // Các tuyến trên mặt Pareto, sắp theo thời gian tăng dần; rỗng nếu không có đường
+    std::vector<ParetoRouteResult> findParetoRoutes(const std::string& start,
+                                                    const std::string& goal);
+    std::vector<ParetoRouteResult> findParetoRoutes(uint32_t source, uint32_t target);
+
+private:
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+    static constexpr int CRITERIA = 3;
+
+    struct Label {
+        double cost[CRITERIA];
+        uint32_t node;
+        uint32_t parent;        // chỉ số nhãn cha trong labels_, NONE ở nguồn
+        bool dead;              // bị một nhãn mới hơn trội, bỏ khi lấy ra
+    };
+
+    RoadMap& map_;
+    size_t maxLabels_ = 2000000;
+    bool truncated_ = false;
+
+    std::vector<Label> labels_;
+    std::vector<std::vector<uint32_t>> bags_;   // túi nhãn sống của mỗi node
+    std::vector<uint32_t> touched_;             // node có túi khác rỗng
+    std::vector<double> bound_[CRITERIA];       // cận dưới tới đích theo từng tiêu chí
+
+    void computeBounds(const CompactGraph& g, uint32_t target);
+    bool dominatedByBag(const std::vector<uint32_t>& bag, const double* cost) const;
+};
@@ -0,0 +1,255 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Các hàng đợi ưu tiên cắm được vào tìm kiếm (xem ShortestPath::dijkstraWith).
+// Giao diện chung:
+//   reset(n)        chuẩn bị cho truy vấn mới trên đồ thị n node, giữ lại dung lượng
+//   push(key, v)    thêm v với khóa key (hàng đợi có decrease-key thì giảm khóa nếu v đã có)
+//   pop()           lấy (key, v) có khóa nhỏ nhất
+//   empty()
+//   overflowed()    true nếu có khóa bị từ chối từ lần reset trước (chỉ BucketQueue)
+// INTEGER_KEYS = true: khóa là số nguyên không âm (chế độ weight lượng tử hóa).
+// RadixHeap và BucketQueue yêu cầu khóa đơn điệu: khóa được push không nhỏ hơn
+// khóa vừa pop (đúng với Dijkstra trên weight không âm).
+
+// Heap nhị phân xóa lười: một node có thể nằm nhiều lần, bản cũ bị bỏ khi pop
+class BinaryHeapQueue {
+public:
+    static constexpr bool INTEGER_KEYS = false;
+    using Entry = std::pair<double, uint32_t>;
+
+    void reset(uint32_t) { heap_.clear(); }
+    void push(double key, uint32_t v) {
+        heap_.push_back({key, v});
+        std::push_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+    }
+    Entry pop() {
+        std::pop_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+        Entry top = heap_.back();
+        heap_.pop_back();
+        return top;
+    }
+    bool empty() const { return heap_.empty(); }
+    bool overflowed() const { return false; }
+
+private:
+    std::vector<Entry> heap_;
+};
+
+// Heap 4-ngả có chỉ mục: mỗi node nằm tối đa một lần, push trên node đã có là
+// decrease-key. Cây nông hơn heap nhị phân và 4 con nằm liền nhau trong bộ nhớ.
+class IndexedFourAryHeap {
+public:
+    static constexpr bool INTEGER_KEYS = false;
+    using Entry = std::pair<double, uint32_t>;
+
+    void reset(uint32_t n) {
+        for (const Entry& e : heap_) pos_[e.second] = NOT_IN_HEAP;
+        heap_.clear();
+        if (pos_.size() < n) pos_.resize(n, NOT_IN_HEAP);
+    }
+
+    void push(double key, uint32_t v) {
+        uint32_t i = pos_[v];
+        if (i == NOT_IN_HEAP) {
+            i = static_cast<uint32_t>(heap_.size());
+            heap_.push_back({key, v});
+        } else if (key < heap_[i].first) {
+            heap_[i].first = key;
+        } else {
+            return;
+        }
+        siftUp(i);
+    }
+
+    Entry pop() {
+        Entry top = heap_[0];
+        pos_[top.second] = NOT_IN_HEAP;
+        Entry last = heap_.back();
+        heap_.pop_back();
+        if (!heap_.empty()) {
+            heap_[0] = last;
+            siftDown(0);
+        }
+        return top;
+    }
+
+    bool empty() const { return heap_.empty(); }
+    bool overflowed() const { return false; }
+
+private:
+    static constexpr uint32_t NOT_IN_HEAP = 0xFFFFFFFFu;
+    static constexpr uint32_t ARITY = 4;
+
+    std::vector<Entry> heap_;
+    std::vector<uint32_t> pos_;     // vị trí của node trong heap_
+
+    void place(uint32_t i, const Entry& e) {
+        heap_[i] = e;
+        pos_[e.second] = i;
+    }
+
+    void siftUp(uint32_t i) {
+        Entry e = heap_[i];
+        while (i > 0) {
+            uint32_t p = (i - 1) / ARITY;
+            if (!(e.first < heap_[p].first)) break;
+            place(i, heap_[p]);
+            i = p;
+        }
+        place(i, e);
+    }
+
+    void siftDown(uint32_t i) {
+        Entry e = heap_[i];
+        const uint32_t n = static_cast<uint32_t>(heap_.size());
+        while (true) {
+            uint32_t first = i * ARITY + 1;
+            if (first >= n) break;
+            uint32_t best = first;
+            uint32_t last = std::min(n, first + ARITY);
+            for (uint32_t c = first + 1; c < last; c++)
+                if (heap_[c].first < heap_[best].first) best = c;
+            if (!(heap_[best].first < e.first)) break;
+            place(i, heap_[best]);
+            i = best;
+        }
+        place(i, e);
+    }
+};
+
+// Radix heap (Ahuja và cộng sự) cho khóa đơn điệu. Khóa double không âm được so
+// sánh qua mẫu bit IEEE-754 (thứ tự mẫu bit trùng thứ tự giá trị), phần tử nằm ở
+// bucket theo bit cao nhất khác với khóa vừa pop, nên mỗi phần tử chỉ bị dời
+// xuống tối đa 64 lần và không cần so sánh trong heap.
+class RadixHeap {
+public:
+    static constexpr bool INTEGER_KEYS = false;
+    using Entry = std::pair<double, uint32_t>;
+
+    void reset(uint32_t) {
+        for (auto& b : buckets_) b.clear();
+        size_ = 0;
+        last_ = 0;
+    }
+
+    void push(double key, uint32_t v) {
+        uint64_t k = bits(key);
+        buckets_[bucketOf(k)].push_back({k, v});
+        size_++;
+    }
+
+    Entry pop() {
+        if (buckets_[0].empty()) {
+            size_t i = 1;
+            while (buckets_[i].empty()) i++;
+            // khóa nhỏ nhất của bucket i trở thành mốc mới, rồi chia lại bucket i
+            uint64_t minKey = buckets_[i][0].first;
+            for (const auto& e : buckets_[i]) minKey = std::min(minKey, e.first);
+            last_ = minKey;
+            for (const auto& e : buckets_[i]) buckets_[bucketOf(e.first)].push_back(e);
+            buckets_[i].clear();
+        }
+        auto e = buckets_[0].back();
+        buckets_[0].pop_back();
+        size_--;
+        return {value(e.first), e.second};
+    }
+
+    bool empty() const { return size_ == 0; }
+    bool overflowed() const { return false; }
+
+private:
+    std::vector<std::pair<uint64_t, uint32_t>> buckets_[65];
+    size_t size_ = 0;
+    uint64_t last_ = 0;
+
+    size_t bucketOf(uint64_t k) const {
+        return k == last_ ? 0 : 64 - static_cast<size_t>(__builtin_clzll(k ^ last_));
+    }
+    static uint64_t bits(double d) {
+        uint64_t k;
+        std::memcpy(&k, &d, sizeof(k));
+        return k;
+    }
+    static double value(uint64_t k) {
+        double d;
+        std::memcpy(&d, &k, sizeof(d));
+        return d;
+    }
+};
+
+// Hàng đợi bucket kiểu Dial cho khóa nguyên: vòng bucket có kích thước lũy thừa
+// của 2, lớn hơn weight cung lớn nhất đã gặp (tự mở rộng khi cần). Mọi khóa đang
+// chờ nằm trong [cursor, cursor + size) nên mỗi bucket ứng với đúng một khóa.
+// Khóa cách cursor từ MAX_SPAN trở lên (Edge tốc độ 0 có weight 1e9 giờ, weight vô
+// cực, ...) không được đưa vào: hàng đợi bật overflowed() và người gọi phải chạy
+// lại bằng hàng đợi khác, để vòng không bao giờ bị cấp theo một khóa không chặn.
+class BucketQueue {
+public:
+    static constexpr bool INTEGER_KEYS = true;
+    static constexpr uint64_t MAX_SPAN = uint64_t(1) << 18;    // ~7,3 giờ theo 1/10 giây
+    using Entry = std::pair<double, uint32_t>;
+
+    void reset(uint32_t) {
+        // phần còn lại sau khi dừng sớm nằm liền sau cursor_
+        const uint64_t mask = ring_.size() - 1;
+        for (; size_ > 0; cursor_++) {
+            size_ -= ring_[cursor_ & mask].size();
+            ring_[cursor_ & mask].clear();
+        }
+        cursor_ = 0;
+        overflow_ = false;
+        if (ring_.empty()) ring_.resize(1024);
+    }
+
+    void push(double key, uint32_t v) {
+        // so sánh trên double: NaN và vô cực cũng rơi vào nhánh tràn
+        if (!(key - static_cast<double>(cursor_) < static_cast<double>(MAX_SPAN))) {
+            overflow_ = true;
+            return;
+        }
+        uint64_t k = static_cast<uint64_t>(key);
+        if (k - cursor_ >= ring_.size()) grow(k - cursor_ + 1);
+        ring_[k & (ring_.size() - 1)].push_back(v);
+        size_++;
+    }
+
+    Entry pop() {
+        const uint64_t mask = ring_.size() - 1;
+        while (ring_[cursor_ & mask].empty()) cursor_++;
+        auto& b = ring_[cursor_ & mask];
+        uint32_t v = b.back();
+        b.pop_back();
+        size_--;
+        return {static_cast<double>(cursor_), v};
+    }
+
+    bool empty() const { return size_ == 0; }
+    // Có khóa bị từ chối kể từ reset() gần nhất: kết quả tìm kiếm không dùng được
+    bool overflowed() const { return overflow_; }
+
+private:
+    std::vector<std::vector<uint32_t>> ring_;
+    size_t size_ = 0;
+    bool overflow_ = false;
+    uint64_t cursor_ = 0;       // không lớn hơn khóa nhỏ nhất đang chờ
+
+    void grow(uint64_t span) {
+        size_t cap = ring_.size();
+        while (cap < span) cap *= 2;
+        std::vector<std::vector<uint32_t>> ring(cap);
+        const uint64_t oldMask = ring_.size() - 1;
+        for (uint64_t i = 0; i < ring_.size(); i++) {
+            uint64_t k = cursor_ + ((i - cursor_) & oldMask);
+            auto& dst = ring[k & (cap - 1)];
+            dst.insert(dst.end(), ring_[i].begin(), ring_[i].end());
+        }
+        ring_.swap(ring);
+    }
+};
@@ -1,19 +1,34 @@
 #include "RoadMap.h"
+#include "GeoUtils.h"
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <algorithm>
+#include <atomic>
 #include <sstream> // Thêm thư viện này nếu cần xử lý chuỗi phức tạp hơn trong tương lai
 
 using namespace std;
 
+namespace {
+    // Số mục tối đa của CompactGraph::changeLog; vượt quá thì bỏ nửa cũ
+    const size_t CHANGE_LOG_LIMIT = 1 << 16;
+}
+
 /**
  * @brief Xóa toàn bộ dữ liệu bản đồ.
  */
 void RoadMap::clear() {
     nodes_.clear();
     edges_.clear();
+    twinOf_.clear();
     adj_.clear();
     edgeById_.clear();
     blockedEdges_.clear();
+    nodeOrder_.clear();
+    profileClasses_.clear();
+    edgeProfiles_.clear();
+    turnCosts_.clear();
+    graphDirty_ = true;
 }
 
 /**
@@ -73,6 +88,33 @@ bool RoadMap::loadFromFile(const string& filename) {
         }
     }
 
+    // 3. (Tùy chọn) Profile thời gian theo giờ trong ngày
+    //    <số lớp>, mỗi lớp: <tên> <k> <k breakpoint>
+    //    <số profile>, mỗi profile: <ID Edge> <tên lớp> <k hệ số>
+    int classCount;
+    if (f >> classCount) {
+        for (int i = 0; i < classCount; i++) {
+            string name;
+            int k;
+            if (!(f >> name >> k) || k <= 0) return false;
+            vector<double> breakpoints(k);
+            for (double& b : breakpoints) f >> b;
+            addProfileClass(name, breakpoints);
+        }
+
+        int profileCount;
+        if (!(f >> profileCount)) return false;
+        for (int i = 0; i < profileCount; i++) {
+            string edgeId, className;
+            if (!(f >> edgeId >> className)) return false;
+            size_t k = 0;
+            for (auto& c : profileClasses_) if (c.name == className) k = c.breakpoints.size();
+            vector<double> factors(k);
+            for (double& x : factors) f >> x;
+            if (!setEdgeProfile(edgeId, className, factors)) return false;
+        }
+    }
+
     return true;
 }
 
@@ -83,11 +125,14 @@ bool RoadMap::saveToFile(const string& filename) const {
     ofstream f(filename);
     if (!f.is_open()) return false;
 
-    // 1. Lưu Nodes
-    f << nodes_.size() << "\n";
-    for (auto &p : nodes_)
-        f << p.first << " " << p.second->name << " "
-          << p.second->lat << " " << p.second->lon << "\n";
+    // 1. Lưu Nodes theo thứ tự thêm vào, để nạp lại cho cùng chỉ số node trong
+    //    graph() (tệp đi kèm như nhãn hub nhận diện đồ thị theo chỉ số)
+    f << nodeOrder_.size() << "\n";
+    for (const string& id : nodeOrder_) {
+        const auto& node = nodes_.at(id);
+        f << id << " " << node->name << " "
+          << node->lat << " " << node->lon << "\n";
+    }
 
     // 2. Lưu Edges (chỉ lưu Edge gốc, không lưu Edge reverse)
     int cnt = 0;
@@ -110,6 +155,22 @@ bool RoadMap::saveToFile(const string& filename) const {
           << "\n";
     }
 
+    // 3. Lưu profile thời gian (nếu có)
+    if (!profileClasses_.empty()) {
+        f << profileClasses_.size() << "\n";
+        for (auto& c : profileClasses_) {
+            f << c.name << " " << c.breakpoints.size();
+            for (double b : c.breakpoints) f << " " << b;
+            f << "\n";
+        }
+        f << edgeProfiles_.size() << "\n";
+        for (auto& p : edgeProfiles_) {
+            f << p.first << " " << profileClasses_[p.second.cls].name;
+            for (double x : p.second.factors) f << " " << x;
+            f << "\n";
+        }
+    }
+
     return true;
 }
 
@@ -119,6 +180,8 @@ bool RoadMap::saveToFile(const string& filename) const {
 bool RoadMap::addNode(const string& id, const string& name, double lat, double lon) {
     if (nodes_.count(id)) return false;
     nodes_[id] = make_shared<Node>(id, name, lat, lon);
+    nodeOrder_.push_back(id);
+    graphDirty_ = true;
     return true;
 }
 
@@ -149,6 +212,7 @@ bool RoadMap::addEdge(const string& id, const string& name,
     e->budget = 0;      // Giá trị mặc định
 
     edges_.push_back(e);
+    twinOf_.push_back(CompactGraph::INVALID);
     adj_[src].push_back(e);
     edgeById_[id] = e;
 
@@ -162,11 +226,14 @@ bool RoadMap::addEdge(const string& id, const string& name,
         r->isReverse = true;
         // Các giá trị cap, flow, budget được giữ nguyên
         
+        twinOf_.back() = static_cast<uint32_t>(edges_.size());
         edges_.push_back(r);
+        twinOf_.push_back(CompactGraph::INVALID);
         adj_[dst].push_back(r);
         edgeById_[rev] = r;
     }
 
+    graphDirty_ = true;
     return true;
 }
 
@@ -174,14 +241,17 @@ bool RoadMap::addEdge(const string& id, const string& name,
  * @brief Chặn một Edge (làm cho nó không thể sử dụng trong tìm đường).
  */
 bool RoadMap::blockEdge(const string& edgeId) {
-    if (!edgeById_.count(edgeId)) return false;
-    blockedEdges_.insert(edgeId);
+    const CompactGraph& g = graph();
+    uint32_t a = g.findEdge(edgeId);
+    if (a == CompactGraph::INVALID) return false;
 
     // Nếu là đường hai chiều, chặn luôn Edge ngược
-    string rev = edgeId + "_rev";
-    if (edgeById_.count(rev))
-        blockedEdges_.insert(rev);
-
+    for (uint32_t e : {a, g.twin[a]}) {
+        if (e == CompactGraph::INVALID) continue;
+        blockedEdges_.insert(g.edgeIds[e]);
+        if (!graph_.blocked[e]) logEdgeChange(e);
+        graph_.blocked[e] = 1;
+    }
     return true;
 }
 
@@ -189,16 +259,260 @@ bool RoadMap::blockEdge(const string& edgeId) {
  * @brief Bỏ chặn một Edge.
  */
 bool RoadMap::unblockEdge(const string& edgeId) {
-    blockedEdges_.erase(edgeId);
-    blockedEdges_.erase(edgeId + "_rev");
+    const CompactGraph& g = graph();
+    uint32_t a = g.findEdge(edgeId);
+    if (a == CompactGraph::INVALID) return true;
+
+    for (uint32_t e : {a, g.twin[a]}) {
+        if (e == CompactGraph::INVALID) continue;
+        blockedEdges_.erase(g.edgeIds[e]);
+        if (graph_.blocked[e]) logEdgeChange(e);
+        graph_.blocked[e] = 0;
+    }
+    return true;
+}
+
+/**
+ * @brief Đổi tốc độ trung bình của Edge (và Edge ngược nếu có).
+ */
+bool RoadMap::setEdgeSpeed(const string& edgeId, double avgSpeed) {
+    const CompactGraph& g = graph();
+    uint32_t a = g.findEdge(edgeId);
+    if (a == CompactGraph::INVALID) return false;
+
+    // Kiểm tra mọi chiều trước khi đổi để không đổi một nửa
+    for (uint32_t e : {a, g.twin[a]}) {
+        if (e == CompactGraph::INVALID) continue;
+        auto it = edgeProfiles_.find(g.edgeIds[e]);
+        if (it == edgeProfiles_.end()) continue;
+        Edge changed = *arcEdges_[e];
+        changed.avgSpeed = avgSpeed;
+        if (!profileIsFifo(changed.travelTime(), it->second.cls, it->second.factors)) return false;
+    }
+
+    for (uint32_t e : {a, g.twin[a]}) {
+        if (e == CompactGraph::INVALID) continue;
+        arcEdges_[e]->avgSpeed = avgSpeed;
+        refreshEdgeWeight(g.edgeIds[e]);
+    }
+    return true;
+}
+
+/**
+ * @brief Chép travelTime() mới của Edge vào graph() và tăng các số hiệu weight.
+ *        Khi weight giảm, hạ minTimePerKm nếu cần để heuristic A* vẫn đúng.
+ */
+void RoadMap::refreshEdgeWeight(const string& edgeId) {
+    if (graphDirty_) return;    // lần dựng sau sẽ đọc giá trị mới
+
+    refreshCongestedWeight(edgeId);
+    uint32_t a = graph_.findEdge(edgeId);
+    double w = edgeById_[edgeId]->travelTime();
+    double old = graph_.weight[a];
+    if (w == old) return;
+
+    graph_.weight[a] = w;
+    graph_.weightVersion++;
+    logEdgeChange(a);
+    if (w < old) {
+        graph_.decreaseVersion++;
+        double km = haversineKm(graph_.lat[graph_.tail[a]], graph_.lon[graph_.tail[a]],
+                                graph_.lat[graph_.head[a]], graph_.lon[graph_.head[a]]);
+        if (km > 0) graph_.minTimePerKm = min(graph_.minTimePerKm, w / km);
+    }
+    graph_.maxSpeed = max(graph_.maxSpeed, edgeById_[edgeId]->avgSpeed);
+}
+
+/**
+ * @brief Cập nhật lưu lượng của một Edge (không đổi Edge chiều ngược).
+ */
+bool RoadMap::setEdgeFlow(const string& edgeId, double flow) {
+    if (!edgeById_.count(edgeId)) return false;
+    edgeById_[edgeId]->flow = flow;
+    refreshCongestedWeight(edgeId);
+    return true;
+}
+
+/**
+ * @brief Đổi tham số BPR của một loại đường và tính lại thời gian BPR của các Edge thuộc loại đó.
+ */
+void RoadMap::setBprParameters(RoadType type, double alpha, double beta) {
+    bpr_[static_cast<int>(type)] = {alpha, beta};
+    if (graphDirty_) return;
+    for (uint32_t a = 0; a < graph_.numEdges(); a++)
+        if (arcEdges_[a]->type == type)
+            graph_.congestedWeight[a] = bprTravelTime(*arcEdges_[a], bpr_[static_cast<int>(type)]);
+}
+
+/**
+ * @brief Chép thời gian BPR mới của một Edge vào graph().
+ */
+void RoadMap::refreshCongestedWeight(const string& edgeId) {
+    if (graphDirty_) return;
+    uint32_t a = graph_.findEdge(edgeId);
+    const Edge& e = *edgeById_[edgeId];
+    graph_.congestedWeight[a] = bprTravelTime(e, bpr_[static_cast<int>(e.type)]);
+}
+
+/**
+ * @brief Thêm lớp profile với các breakpoint tăng ngặt trong [0, 24).
+ */
+bool RoadMap::addProfileClass(const string& name, const vector<double>& breakpoints) {
+    if (breakpoints.empty()) return false;
+    for (auto& c : profileClasses_) if (c.name == name) return false;
+    for (size_t i = 0; i < breakpoints.size(); i++) {
+        if (breakpoints[i] < 0 || breakpoints[i] >= TimeProfiles::PERIOD) return false;
+        if (i > 0 && breakpoints[i] <= breakpoints[i - 1]) return false;
+    }
+    profileClasses_.push_back({name, breakpoints});
+    return true;
+}
+
+/**
+ * @brief FIFO đúng khi trên mọi đoạn, độ dốc của thời gian đi (weight * độ dốc hệ
+ *        số) không nhỏ hơn -1. Điều kiện phụ thuộc weight nên phải kiểm tra lại khi
+ *        tốc độ đổi.
+ */
+bool RoadMap::profileIsFifo(double weight, uint32_t cls, const vector<double>& factors) const {
+    const vector<double>& b = profileClasses_[cls].breakpoints;
+    for (size_t i = 0; i < b.size(); i++) {
+        size_t j = (i + 1) % b.size();
+        double span = j > i ? b[j] - b[i] : b[j] + TimeProfiles::PERIOD - b[i];
+        if (weight * (factors[j] - factors[i]) / span < -1) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Gán profile cho Edge nếu profile hợp lệ và FIFO với tốc độ hiện tại.
+ */
+bool RoadMap::setEdgeProfile(const string& edgeId, const string& className,
+                             const vector<double>& factors) {
+    if (!edgeById_.count(edgeId)) return false;
+    uint32_t cls = TimeProfiles::NONE;
+    for (uint32_t c = 0; c < profileClasses_.size(); c++)
+        if (profileClasses_[c].name == className) cls = c;
+    if (cls == TimeProfiles::NONE) return false;
+
+    const vector<double>& b = profileClasses_[cls].breakpoints;
+    if (factors.size() != b.size()) return false;
+    for (double x : factors) if (!(x > 0)) return false;
+
+    if (!profileIsFifo(edgeById_[edgeId]->travelTime(), cls, factors)) return false;
+
+    edgeProfiles_[edgeId] = {cls, factors};
+    if (!graphDirty_) buildProfiles(graph_);
+    return true;
+}
+
+/**
+ * @brief Làm phẳng profile theo chỉ số Edge của g và tính sẵn độ dốc từng đoạn.
+ */
+void RoadMap::buildProfiles(CompactGraph& g) const {
+    TimeProfiles p;
+    if (!edgeProfiles_.empty()) {
+        p.classFirst.assign(1, 0);
+        for (auto& c : profileClasses_) {
+            p.breakpoints.insert(p.breakpoints.end(), c.breakpoints.begin(), c.breakpoints.end());
+            p.classFirst.push_back(static_cast<uint32_t>(p.breakpoints.size()));
+        }
+        p.edgeClass.assign(g.numEdges(), TimeProfiles::NONE);
+        p.edgeFirst.assign(g.numEdges(), 0);
+        for (auto& ep : edgeProfiles_) {
+            uint32_t a = g.findEdge(ep.first);
+            const vector<double>& b = profileClasses_[ep.second.cls].breakpoints;
+            const vector<double>& x = ep.second.factors;
+            p.edgeClass[a] = ep.second.cls;
+            p.edgeFirst[a] = static_cast<uint32_t>(p.factor.size());
+            for (size_t i = 0; i < b.size(); i++) {
+                size_t j = (i + 1) % b.size();
+                double span = j > i ? b[j] - b[i] : b[j] + TimeProfiles::PERIOD - b[i];
+                p.factor.push_back(x[i]);
+                p.slope.push_back((x[j] - x[i]) / span);
+                p.minFactor = min(p.minFactor, x[i]);
+            }
+        }
+    }
+    g.profiles = std::move(p);
+}
+
+/**
+ * @brief Đặt chi phí rẽ giữa hai Edge nối tiếp nhau.
+ */
+bool RoadMap::setTurnCost(const string& fromEdge, const string& toEdge, double cost) {
+    if (!edgeById_.count(fromEdge) || !edgeById_.count(toEdge)) return false;
+    if (edgeById_[fromEdge]->dst != edgeById_[toEdge]->src || cost < 0) return false;
+    turnCosts_[{fromEdge, toEdge}] = cost;
+    if (!graphDirty_) buildTurns(graph_);
     return true;
 }
 
+bool RoadMap::forbidTurn(const string& fromEdge, const string& toEdge) {
+    return setTurnCost(fromEdge, toEdge, numeric_limits<double>::infinity());
+}
+
+void RoadMap::setUTurnPenalty(double cost) {
+    uTurnPenalty_ = cost;
+    if (!graphDirty_) graph_.uTurnPenalty = cost;
+}
+
+void RoadMap::clearTurnCosts() {
+    turnCosts_.clear();
+    uTurnPenalty_ = 0;
+    if (!graphDirty_) buildTurns(graph_);
+}
+
+/**
+ * @brief Gom chi phí rẽ vào bảng nhỏ của node giữa, sắp theo (from, to).
+ */
+void RoadMap::buildTurns(CompactGraph& g) const {
+    g.turns.clear();
+    g.turnFirst.clear();
+    g.uTurnPenalty = uTurnPenalty_;
+    if (turnCosts_.empty()) return;
+
+    const uint32_t n = g.numNodes();
+    g.turnFirst.assign(n + 1, 0);
+    vector<TurnEntry> entries;
+    for (auto& t : turnCosts_) {
+        uint32_t from = g.findEdge(t.first.first), to = g.findEdge(t.first.second);
+        entries.push_back({from, to, t.second});
+        g.turnFirst[g.head[from] + 1]++;
+    }
+    for (uint32_t v = 0; v < n; v++) g.turnFirst[v + 1] += g.turnFirst[v];
+    g.turns.resize(entries.size());
+    vector<uint32_t> pos(g.turnFirst.begin(), g.turnFirst.end() - 1);
+    for (auto& e : entries) g.turns[pos[g.head[e.from]]++] = e;
+    for (uint32_t v = 0; v < n; v++)
+        sort(g.turns.begin() + g.turnFirst[v], g.turns.begin() + g.turnFirst[v + 1],
+             [](const TurnEntry& a, const TurnEntry& b) {
+                 return a.from != b.from ? a.from < b.from : a.to < b.to;
+             });
+}
+
 /**
  * @brief Bỏ chặn tất cả các Edge.
  */
 void RoadMap::unblockAll() {
     blockedEdges_.clear();
+    if (graphDirty_) return;
+    for (uint32_t e = 0; e < graph_.numEdges(); e++) {
+        if (graph_.blocked[e]) logEdgeChange(e);
+        graph_.blocked[e] = 0;
+    }
+}
+
+/**
+ * @brief Ghi Edge vừa đổi vào nhật ký của graph_; giữ tối đa CHANGE_LOG_LIMIT mục.
+ */
+void RoadMap::logEdgeChange(uint32_t edge) {
+    auto& log = graph_.changeLog;
+    if (log.size() >= CHANGE_LOG_LIMIT) {
+        size_t drop = log.size() / 2;
+        log.erase(log.begin(), log.begin() + drop);
+        graph_.changeLogStart += drop;
+    }
+    log.push_back(edge);
 }
 
 /**
@@ -265,6 +579,112 @@ shared_ptr<Edge> RoadMap::getEdgeById(const string& id) {
     return edgeById_[id];
 }
 
+/**
+ * @brief Trả về đồ thị CSR, dựng lại nếu bản đồ đã thay đổi kể từ lần dựng trước.
+ */
+const CompactGraph& RoadMap::graph() const {
+    if (graphDirty_) buildGraph();
+    return graph_;
+}
+
+/**
+ * @brief Trả về Edge ứng với chỉ số cung trong graph().
+ */
+const Edge& RoadMap::edgeAt(uint32_t edgeIndex) const {
+    if (graphDirty_) buildGraph();
+    return *arcEdges_[edgeIndex];
+}
+
+/**
+ * @brief Dựng đồ thị CSR: đánh số node theo thứ tự thêm vào, sắp các cung theo
+ *        node nguồn (giữ nguyên thứ tự thêm vào trong cùng một node), kèm chỉ mục
+ *        ngược các cung đi vào mỗi node.
+ */
+void RoadMap::buildGraph() const {
+    CompactGraph g;
+    const uint32_t n = static_cast<uint32_t>(nodeOrder_.size());
+    const uint32_t m = static_cast<uint32_t>(edges_.size());
+
+    g.nodeIds = nodeOrder_;
+    g.nodeIndex.reserve(n);
+    for (uint32_t i = 0; i < n; i++) g.nodeIndex[nodeOrder_[i]] = i;
+
+    // Đếm bậc ra rồi cộng dồn để ra offset
+    g.firstOut.assign(n + 1, 0);
+    for (auto &e : edges_) g.firstOut[g.nodeIndex[e->src] + 1]++;
+    for (uint32_t i = 0; i < n; i++) g.firstOut[i + 1] += g.firstOut[i];
+
+    g.head.resize(m);
+    g.tail.resize(m);
+    g.weight.resize(m);
+    g.blocked.assign(m, 0);
+    g.twin.assign(m, CompactGraph::INVALID);
+    g.length.resize(m);
+    g.budget.resize(m);
+    g.roadType.resize(m);
+    g.congestedWeight.resize(m);
+    g.edgeIds.resize(m);
+    g.edgeIndex.reserve(m);
+    arcEdges_.assign(m, nullptr);
+
+    vector<uint32_t> pos(g.firstOut.begin(), g.firstOut.end() - 1);
+    vector<uint32_t> arcOf(m);      // vị trí trong edges_ -> chỉ số cung
+    for (uint32_t i = 0; i < m; i++) {
+        auto &e = edges_[i];
+        uint32_t u = g.nodeIndex[e->src];
+        uint32_t a = pos[u]++;
+        arcOf[i] = a;
+        g.tail[a] = u;
+        g.head[a] = g.nodeIndex[e->dst];
+        g.weight[a] = e->travelTime();
+        g.blocked[a] = blockedEdges_.count(e->id) ? 1 : 0;
+        g.length[a] = e->length;
+        g.budget[a] = e->budget;
+        g.roadType[a] = static_cast<uint8_t>(e->type);
+        g.congestedWeight[a] = bprTravelTime(*e, bpr_[static_cast<int>(e->type)]);
+        g.edgeIds[a] = e->id;
+        g.edgeIndex[e->id] = a;
+        arcEdges_[a] = e;
+    }
+    for (uint32_t i = 0; i < m; i++)
+        if (twinOf_[i] != CompactGraph::INVALID) g.twin[arcOf[i]] = arcOf[twinOf_[i]];
+
+    // Chỉ mục ngược: đếm bậc vào, cộng dồn, rải chỉ số cung theo node đích
+    g.firstIn.assign(n + 1, 0);
+    for (uint32_t a = 0; a < m; a++) g.firstIn[g.head[a] + 1]++;
+    for (uint32_t i = 0; i < n; i++) g.firstIn[i + 1] += g.firstIn[i];
+    g.inEdge.resize(m);
+    pos.assign(g.firstIn.begin(), g.firstIn.end() - 1);
+    for (uint32_t a = 0; a < m; a++) g.inEdge[pos[g.head[a]]++] = a;
+
+    // Tọa độ và cận dưới thời gian theo km chim bay cho A*
+    g.lat.resize(n);
+    g.lon.resize(n);
+    for (uint32_t i = 0; i < n; i++) {
+        auto &node = nodes_.at(nodeOrder_[i]);
+        g.lat[i] = node->lat;
+        g.lon[i] = node->lon;
+    }
+    g.maxSpeed = 0;
+    g.minTimePerKm = numeric_limits<double>::infinity();
+    for (uint32_t a = 0; a < m; a++) {
+        g.maxSpeed = max(g.maxSpeed, arcEdges_[a]->avgSpeed);
+        double km = haversineKm(g.lat[g.tail[a]], g.lon[g.tail[a]],
+                                g.lat[g.head[a]], g.lon[g.head[a]]);
+        if (km > 0) g.minTimePerKm = min(g.minTimePerKm, g.weight[a] / km);
+    }
+    if (g.minTimePerKm == numeric_limits<double>::infinity()) g.minTimePerKm = 0;
+
+    buildProfiles(g);
+    buildTurns(g);
+
+    static std::atomic<uint64_t> buildCounter{0};
+    g.version = ++buildCounter;
+
+    graph_ = std::move(g);
+    graphDirty_ = false;
+}
+
 /**
  * @brief In thông tin bản đồ ra console.
  */
@@ -4,6 +4,9 @@
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <map>
+#include <cmath>
+#include "CompactGraph.h"
 
 enum class Direction { ONE_WAY = 1, TWO_WAY = 2 };
 enum class RoadType { HIGHWAY=0, MAIN_ROAD=1, STREET=2, ALLEY=3, BRIDGE=4, TUNNEL=5 };
@@ -45,10 +48,23 @@ struct Edge {
           dir(Direction::ONE_WAY), type(RoadType::STREET) {}
 
     double travelTime() const {
-        return avgSpeed > 0 ? length / avgSpeed : 1e9;
+        return avgSpeed > 0 ? length / avgSpeed : CompactGraph::NO_SPEED_WEIGHT;
     }
 };
 
+// Tham số hàm trễ BPR (Bureau of Public Roads):
+// t = t0 * (1 + alpha * (flow / capacity)^beta), t0 = travelTime() khi đường thông thoáng
+struct BprParameters {
+    double alpha = 0.15;
+    double beta = 4.0;
+};
+
+inline double bprTravelTime(const Edge& e, const BprParameters& p) {
+    double t0 = e.travelTime();
+    if (e.capacity <= 0 || e.flow <= 0) return t0;
+    return t0 * (1.0 + p.alpha * std::pow(e.flow / e.capacity, p.beta));
+}
+
 class RoadMap {
 public:
     RoadMap() = default;
@@ -66,6 +82,42 @@ public:
     bool blockEdge(const std::string& edgeId);
     bool unblockEdge(const std::string& edgeId);
     void unblockAll();
+    bool hasBlockedEdges() const { return !blockedEdges_.empty(); }
+
+    // Cập nhật tốc độ trung bình (cả Edge ngược nếu là đường hai chiều) và
+    // weight tương ứng trong graph() mà không phải dựng lại đồ thị. Từ chối (không
+    // đổi gì) nếu một chiều có profile thời gian mà profile đó vi phạm FIFO với tốc độ mới.
+    bool setEdgeSpeed(const std::string& edgeId, double avgSpeed);
+
+    // Cập nhật lưu lượng của một Edge (một chiều) và thời gian BPR tương ứng trong
+    // graph().congestedWeight, chỉ tính lại đúng Edge đó
+    bool setEdgeFlow(const std::string& edgeId, double flow);
+
+    // Lớp profile thời gian: các breakpoint (giờ trong ngày, tăng dần trong [0, 24))
+    // dùng chung cho mọi Edge thuộc lớp. Trả về false nếu tên đã có hoặc breakpoint sai.
+    bool addProfileClass(const std::string& name, const std::vector<double>& breakpoints);
+    // Gán profile cho một Edge (một chiều): factors[i] là hệ số nhân travelTime() tại
+    // breakpoint i của lớp. Từ chối nếu sai số lượng, có hệ số <= 0, hoặc profile vi
+    // phạm FIFO với tốc độ hiện tại (vào Edge muộn hơn thì không được ra sớm hơn);
+    // setEdgeSpeed kiểm tra lại khi tốc độ đổi. loadFromFile trả về false nếu file có
+    // profile bị từ chối.
+    bool setEdgeProfile(const std::string& edgeId, const std::string& className,
+                        const std::vector<double>& factors);
+    bool hasTimeProfiles() const { return !edgeProfiles_.empty(); }
+
+    // Chi phí rẽ (giờ) từ Edge fromEdge sang Edge toEdge; hai Edge phải nối tiếp
+    // nhau (fromEdge.dst == toEdge.src). forbidTurn = chi phí vô hạn.
+    bool setTurnCost(const std::string& fromEdge, const std::string& toEdge, double cost);
+    bool forbidTurn(const std::string& fromEdge, const std::string& toEdge);
+    // Chi phí mặc định cho mọi lần quay đầu không có mục riêng (0 = miễn phí)
+    void setUTurnPenalty(double cost);
+    void clearTurnCosts();
+
+    // Tham số BPR theo loại đường; mặc định alpha = 0.15, beta = 4 cho mọi loại
+    void setBprParameters(RoadType type, double alpha, double beta);
+    const BprParameters& bprParameters(RoadType type) const {
+        return bpr_[static_cast<int>(type)];
+    }
 
     // Phương thức kiểm tra Node đã có trong file header của bạn
     bool hasNode(const std::string& id) const; 
@@ -83,12 +135,48 @@ public:
 
     std::shared_ptr<Edge> getEdgeById(const std::string& id);
 
+    // Đồ thị CSR đóng băng, được dựng lại khi bản đồ thay đổi cấu trúc.
+    // Tham chiếu trả về hợp lệ cho tới lần addNode/addEdge/clear/loadFromFile kế tiếp.
+    const CompactGraph& graph() const;
+
+    // Edge tương ứng với chỉ số cung trong graph()
+    const Edge& edgeAt(uint32_t edgeIndex) const;
+
     void printMap() const;
 
 private:
+    void buildGraph() const;
+    void refreshEdgeWeight(const std::string& edgeId);
+    void logEdgeChange(uint32_t edge);
+    void refreshCongestedWeight(const std::string& edgeId);
+    void buildProfiles(CompactGraph& g) const;
+    bool profileIsFifo(double weight, uint32_t cls, const std::vector<double>& factors) const;
+    void buildTurns(CompactGraph& g) const;
+
     std::unordered_map<std::string, std::shared_ptr<Node>> nodes_;
     std::vector<std::shared_ptr<Edge>> edges_;
+    std::vector<uint32_t> twinOf_;      // theo edges_: vị trí Edge ngược của Edge gốc hai chiều
     std::unordered_map<std::string, std::vector<std::shared_ptr<Edge>>> adj_;
     std::unordered_map<std::string, std::shared_ptr<Edge>> edgeById_;
     std::unordered_set<std::string> blockedEdges_;
+    std::vector<std::string> nodeOrder_;
+    BprParameters bpr_[6];      // theo RoadType
+
+    struct ProfileClass {
+        std::string name;
+        std::vector<double> breakpoints;
+    };
+    struct EdgeProfile {
+        uint32_t cls;
+        std::vector<double> factors;
+    };
+    std::vector<ProfileClass> profileClasses_;
+    std::unordered_map<std::string, EdgeProfile> edgeProfiles_;
+
+    std::map<std::pair<std::string, std::string>, double> turnCosts_;
+    double uTurnPenalty_ = 0;
+
+    mutable CompactGraph graph_;
+    mutable std::vector<std::shared_ptr<Edge>> arcEdges_;
+    mutable bool graphDirty_ = true;
 };
\ No newline at end of file
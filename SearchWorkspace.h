@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+// Bộ nhớ làm việc dùng lại giữa các truy vấn tìm đường.
+// dist/parent là mảng phẳng theo chỉ số node; thay vì xóa O(N) sau mỗi truy vấn,
+// mỗi ô mang một "tem phiên bản" và chỉ được coi là hợp lệ khi tem trùng với
+// phiên bản hiện tại. Mỗi luồng có workspace riêng (xem forThread()); tìm kiếm
+// hai chiều dùng slot 0 cho chiều xuôi và slot 1 cho chiều ngược.
+class SearchWorkspace {
+public:
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+    // Chuẩn bị cho một truy vấn mới trên đồ thị n node
+    void reset(uint32_t n) {
+        if (stamp_.size() < n) {
+            dist_.resize(n);
+            parent_.resize(n);
+            stamp_.resize(n, 0);
+        }
+        if (++version_ == 0) {
+            // tràn số phiên bản: xóa tem một lần rồi bắt đầu lại
+            std::fill(stamp_.begin(), stamp_.end(), 0);
+            version_ = 1;
+        }
+        heap_.clear();
+    }
+
+    bool reached(uint32_t v) const { return stamp_[v] == version_; }
+    double dist(uint32_t v) const {
+        return reached(v) ? dist_[v] : std::numeric_limits<double>::infinity();
+    }
+    uint32_t parent(uint32_t v) const { return reached(v) ? parent_[v] : NONE; }
+
+    void set(uint32_t v, double d, uint32_t parentEdge) {
+        stamp_[v] = version_;
+        dist_[v] = d;
+        parent_[v] = parentEdge;
+    }
+
+    // Hàng đợi ưu tiên nhị phân trên vector giữ lại dung lượng giữa các truy vấn
+    void push(double d, uint32_t v) {
+        heap_.push_back({d, v});
+        std::push_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+    }
+    std::pair<double, uint32_t> pop() {
+        std::pop_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+        Entry top = heap_.back();
+        heap_.pop_back();
+        return top;
+    }
+    bool empty() const { return heap_.empty(); }
+    double topKey() const { return heap_.front().first; }
+
+    static constexpr unsigned SLOTS = 2;
+
+    // Workspace riêng của luồng hiện tại
+    static SearchWorkspace& forThread(unsigned slot = 0) {
+        thread_local SearchWorkspace ws[SLOTS];
+        return ws[slot];
+    }
+
+private:
+    using Entry = std::pair<double, uint32_t>;
+
+    std::vector<double> dist_;
+    std::vector<uint32_t> parent_;
+    std::vector<uint32_t> stamp_;
+    std::vector<Entry> heap_;
+    uint32_t version_ = 0;
+};
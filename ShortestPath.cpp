@@ -1,7 +1,10 @@
 // ShortestPath.cpp
 #include "ShortestPath.h"
-#include <queue>
-#include <unordered_map>
+#include "SearchWorkspace.h"
+#include "GeoUtils.h"
+#include "PriorityQueues.h"
+#include <cmath>
+#include <type_traits>
 #include <limits>
 #include <iostream>
 #include <algorithm>  // <-- cần thiết cho std::reverse
@@ -10,60 +13,607 @@ using namespace std;
 
 ShortestPath::ShortestPath(RoadMap& map) : map_(map) {}
 
+const ClosureSet* ShortestPath::activeClosures() const {
+    if (!closures_ || closures_->empty() || !closures_->isValidFor(map_.graph())) return nullptr;
+    return closures_;
+}
+
 double ShortestPath::findShortestPath(const string& start,
                                       const string& goal,
                                       vector<string>& outPath) {
 
-    auto INF = numeric_limits<double>::infinity();
-    unordered_map<string, double> dist;
-    unordered_map<string, string> parent;
+    const CompactGraph& g = map_.graph();
+    uint32_t s = g.findNode(start);
+    uint32_t t = g.findNode(goal);
+    if (s == CompactGraph::INVALID || t == CompactGraph::INVALID) return -1;
+
+    vector<uint32_t> edges;
+    double d = findShortestPath(s, t, edges);
+    if (d < 0) return -1;
+
+    // chỉ đổi sang chuỗi ID ở biên API
+    outPath.clear();
+    outPath.push_back(start);
+    for (uint32_t a : edges) outPath.push_back(g.nodeIds[g.head[a]]);
+
+    return d;
+}
+
+double ShortestPath::travelTime(const string& start, const string& goal) {
+    const CompactGraph& g = map_.graph();
+    uint32_t s = g.findNode(start);
+    uint32_t t = g.findNode(goal);
+    if (s == CompactGraph::INVALID || t == CompactGraph::INVALID) return -1;
+    return travelTime(s, t);
+}
+
+double ShortestPath::travelTime(uint32_t source, uint32_t target) {
+    const CompactGraph& g = map_.graph();
+    if (hubLabels_ && metric_ == MetricKind::TRAVEL_TIME && hubLabels_->isValidFor(g) &&
+        !map_.hasBlockedEdges() && !g.hasTurnCosts() && !activeClosures())
+        return hubLabels_->distance(source, target);
+
+    vector<uint32_t> edges;
+    return findShortestPath(source, target, edges);
+}
+
+vector<string> EdgeRoute::nodePath(const CompactGraph& g) const {
+    vector<string> path;
+    if (!found()) return path;
+    path.reserve(steps.size() + 1);
+    path.push_back(g.nodeIds[source]);
+    for (const RouteStep& s : steps) path.push_back(g.nodeIds[g.head[s.edge]]);
+    return path;
+}
+
+double ShortestPath::findRoute(const string& start, const string& goal, EdgeRoute& out) {
+    const CompactGraph& g = map_.graph();
+    out.clear();
+    uint32_t s = g.findNode(start);
+    uint32_t t = g.findNode(goal);
+    if (s == CompactGraph::INVALID || t == CompactGraph::INVALID) return -1;
+    return findRoute(s, t, out);
+}
+
+/**
+ * @brief Tìm đường rồi cộng dồn thời gian đi theo từng Edge (luôn theo thời gian,
+ *        kể cả khi hàm chi phí là quãng đường hay budget).
+ */
+double ShortestPath::findRoute(uint32_t source, uint32_t target, EdgeRoute& out) {
+    out.clear();
+    vector<uint32_t> edges;
+    double d = findShortestPath(source, target, edges);
+    if (d < 0) return -1;
+
+    const CompactGraph& g = map_.graph();
+    out.source = source;
+    out.cost = d;
+    out.steps.reserve(edges.size());
+    double time = 0;
+    for (size_t i = 0; i < edges.size(); i++) {
+        if (i > 0 && g.hasTurnCosts()) time += g.turnCost(edges[i - 1], edges[i]);
+        time += g.weight[edges[i]];
+        out.steps.push_back({edges[i], time});
+    }
+    return d;
+}
+
+double ShortestPath::findShortestPath(uint32_t source, uint32_t target,
+                                      vector<uint32_t>& outEdges) {
+
+    const uint32_t n = map_.graph().numNodes();
+    outEdges.clear();
+    if (source >= n || target >= n) return -1;
+
+    if (metric_ != MetricKind::TRAVEL_TIME) {
+        // bảng theo thứ tự MetricKind, mỗi mục là một bản Dijkstra biên dịch riêng
+        using Search = double (ShortestPath::*)(uint32_t, uint32_t, vector<uint32_t>&);
+        static const Search METRIC_SEARCH[] = {
+            &ShortestPath::dijkstraMetric<TravelTimeMetric>,
+            &ShortestPath::dijkstraMetric<DistanceMetric>,
+            &ShortestPath::dijkstraMetric<BudgetMetric>,
+            &ShortestPath::dijkstraMetric<AvoidHighwayMetric>,
+            &ShortestPath::dijkstraMetric<AvoidBridgeMetric>,
+            &ShortestPath::dijkstraMetric<AvoidTunnelMetric>,
+            &ShortestPath::dijkstraMetric<AvoidBridgeTunnelMetric>,
+            &ShortestPath::dijkstraMetric<CongestedTimeMetric>,
+        };
+        return (this->*METRIC_SEARCH[static_cast<int>(metric_)])(source, target, outEdges);
+    }
+
+    if (map_.graph().hasTurnCosts())
+        return edgeBasedDijkstra(source, target, outEdges);
+    if (activeClosures())
+        return dijkstra(source, target, outEdges);
+
+    switch (algorithm_) {
+    case RoutingAlgorithm::BIDIRECTIONAL:
+        return bidirectionalDijkstra(source, target, outEdges);
+    case RoutingAlgorithm::CUSTOMIZABLE_CH:
+        if (cch_ && cch_->isValidFor(map_.graph()) && cch_->isCustomized())
+            return cch_->query(source, target, outEdges);
+        return bidirectionalDijkstra(source, target, outEdges);
+    case RoutingAlgorithm::ASTAR:
+        return astar(source, target, outEdges);
+    case RoutingAlgorithm::ALT:
+        return alt(source, target, outEdges);
+    case RoutingAlgorithm::CONTRACTION_HIERARCHY:
+        if (ch_ && ch_->isValidFor(map_.graph()) && !map_.hasBlockedEdges())
+            return ch_->query(source, target, outEdges);
+        return bidirectionalDijkstra(source, target, outEdges);
+    case RoutingAlgorithm::ARC_FLAGS:
+        if (arcFlags_ && arcFlags_->isValidFor(map_.graph()) && !map_.hasBlockedEdges())
+            return arcFlagsSearch(source, target, outEdges);
+        return dijkstra(source, target, outEdges);
+    case RoutingAlgorithm::DIJKSTRA:
+    default:
+        return dijkstra(source, target, outEdges);
+    }
+}
+
+double ShortestPath::findShortestPathAt(const string& start, const string& goal,
+                                        double departure, vector<string>& outPath) {
+    const CompactGraph& g = map_.graph();
+    uint32_t s = g.findNode(start);
+    uint32_t t = g.findNode(goal);
+    if (s == CompactGraph::INVALID || t == CompactGraph::INVALID) return -1;
+
+    vector<uint32_t> edges;
+    double d = findShortestPathAt(s, t, departure, edges);
+    if (d < 0) return -1;
+
+    outPath.clear();
+    outPath.push_back(start);
+    for (uint32_t a : edges) outPath.push_back(g.nodeIds[g.head[a]]);
+    return d;
+}
 
-    // khởi tạo
-    for (auto &id : map_.getNodeIds())
-        dist[id] = INF;
+double ShortestPath::findShortestPathAt(uint32_t source, uint32_t target, double departure,
+                                        vector<uint32_t>& outEdges) {
+    const CompactGraph& g = map_.graph();
+    outEdges.clear();
+    if (source >= g.numNodes() || target >= g.numNodes()) return -1;
 
-    if (!map_.hasNode(start) || !map_.hasNode(goal)) return -1;
+    if (algorithm_ == RoutingAlgorithm::ASTAR || algorithm_ == RoutingAlgorithm::ALT) {
+        // hệ số profile không nhỏ hơn minFactor nên cận dưới tĩnh nhân minFactor vẫn hợp lệ
+        const double factor = g.minTimePerKm * g.profiles.minFactor * (1 - 1e-9);
+        const double tLat = g.lat[target], tLon = g.lon[target];
+        auto h = [&](uint32_t v) {
+            return factor * haversineKm(g.lat[v], g.lon[v], tLat, tLon);
+        };
+        return timeDependentSearch(source, target, departure, outEdges, h);
+    }
+    return timeDependentSearch(source, target, departure, outEdges,
+                               [](uint32_t) { return 0.0; });
+}
 
-    dist[start] = 0;
+/**
+ * @brief Dijkstra/A* phụ thuộc thời gian: nhãn là thời gian đã đi d, Edge được tính
+ *        tại thời điểm departure + d. Với profile FIFO, đến một node sớm hơn không
+ *        bao giờ làm đến đích muộn hơn, nên tìm kiếm gán nhãn cố định vẫn chính xác.
+ */
+template <class Heuristic>
+double ShortestPath::timeDependentSearch(uint32_t source, uint32_t target, double departure,
+                                         vector<uint32_t>& outEdges, const Heuristic& h) {
 
-    priority_queue<pair<double, string>,
-                   vector<pair<double,string>>,
-                   greater<pair<double,string>>> pq;
+    const CompactGraph& g = map_.graph();
+    const TimeProfiles& profiles = g.profiles;
+    const ClosureSet* closed = activeClosures();
 
-    pq.push({0, start});
+    SearchWorkspace& ws = SearchWorkspace::forThread();
+    ws.reset(g.numNodes());
+    ws.set(source, 0, CompactGraph::INVALID);
+    ws.push(h(source), source);
 
-    while (!pq.empty()) {
-        auto [d, u] = pq.top(); pq.pop();
-        if (d > dist[u]) continue;
+    while (!ws.empty()) {
+        auto [key, u] = ws.pop();
+        double d = ws.dist(u);
+        if (key > d + h(u)) continue;   // mục cũ trong heap
+        if (u == target) break;
 
-        for (auto &e : map_.outgoingEdges(u)) {
-            double w = e.travelTime();
-            if (dist[e.dst] > dist[u] + w) {
-                dist[e.dst] = dist[u] + w;
-                parent[e.dst] = u;
-                pq.push({dist[e.dst], e.dst});
+        for (ArcView arc : g.outArcs(u)) {
+            if (closed && closed->contains(arc.edge)) continue;
+            double nd = d + arc.weight * profiles.factorAt(arc.edge, departure + d);
+            if (nd < ws.dist(arc.target)) {
+                ws.set(arc.target, nd, arc.edge);
+                ws.push(nd + h(arc.target), arc.target);
             }
         }
     }
 
-    if (dist[goal] == INF) return -1;
+    if (!ws.reached(target)) return -1;
 
-    // truy vết đường — an toàn nếu parent không có key
-    outPath.clear();
-    string cur = goal;
-    while (cur != start) {
-        outPath.push_back(cur);
-        if (!parent.count(cur)) {
-            // unexpected: không có đường đầy đủ, trả về lỗi
-            outPath.clear();
-            return -1;
+    for (uint32_t cur = target; cur != source; cur = g.tail[ws.parent(cur)])
+        outEdges.push_back(ws.parent(cur));
+    std::reverse(outEdges.begin(), outEdges.end());
+
+    return ws.dist(target);
+}
+
+bool ShortestPath::isochrone(const string& start, double budget, IsochroneResult& out) {
+    uint32_t s = map_.graph().findNode(start);
+    if (s == CompactGraph::INVALID) {
+        out.clear();
+        return false;
+    }
+    return isochrone(s, budget, out);
+}
+
+/**
+ * @brief Dijkstra dừng khi khóa nhỏ nhất vượt budget. Khi chốt u, mọi cung có
+ *        d(u) + w > budget là Edge biên, đi được (budget - d(u)) / w của Edge.
+ */
+bool ShortestPath::isochrone(uint32_t source, double budget, IsochroneResult& out) {
+    const CompactGraph& g = map_.graph();
+    out.clear();
+    out.budget = budget;
+    if (source >= g.numNodes() || budget < 0) return source < g.numNodes();
+    const ClosureSet* closed = activeClosures();
+
+    SearchWorkspace& ws = SearchWorkspace::forThread();
+    ws.reset(g.numNodes());
+    ws.set(source, 0, CompactGraph::INVALID);
+    ws.push(0, source);
+
+    while (!ws.empty()) {
+        auto [d, u] = ws.pop();
+        if (d > ws.dist(u)) continue;
+        if (d > budget) break;
+        out.nodes.push_back({u, d});
+
+        for (ArcView arc : g.outArcs(u)) {
+            if (closed && closed->contains(arc.edge)) continue;
+            double nd = d + arc.weight;
+            if (nd > budget) {
+                out.boundary.push_back({arc.edge, arc.weight > 0 ? (budget - d) / arc.weight : 0});
+                continue;
+            }
+            if (nd < ws.dist(arc.target)) {
+                ws.set(arc.target, nd, arc.edge);
+                ws.push(nd, arc.target);
+            }
         }
-        cur = parent[cur];
     }
-    outPath.push_back(start);
+    return true;
+}
+
+bool ShortestPath::travelTimesFrom(const string& start, vector<double>& out) {
+    uint32_t s = map_.graph().findNode(start);
+    if (s == CompactGraph::INVALID) {
+        out.clear();
+        return false;
+    }
+    return travelTimesFrom(s, out);
+}
+
+bool ShortestPath::travelTimesFrom(uint32_t source, vector<double>& out) {
+    const CompactGraph& g = map_.graph();
+    if (source >= g.numNodes()) {
+        out.clear();
+        return false;
+    }
+    deltaStepping_.run(g, source, out);
+    for (double& d : out)
+        if (d == numeric_limits<double>::infinity()) d = -1;
+    return true;
+}
+
+double ShortestPath::dijkstra(uint32_t source, uint32_t target,
+                              vector<uint32_t>& outEdges) {
+    return dijkstraMetric<TravelTimeMetric>(source, target, outEdges);
+}
+
+/**
+ * @brief Chọn hàng đợi một lần cho mỗi truy vấn; hàng đợi nguyên chỉ có nghĩa
+ *        với thời gian nên các hàm chi phí khác dùng heap 4-ngả thay thế.
+ */
+template <class Metric>
+double ShortestPath::dijkstraMetric(uint32_t source, uint32_t target,
+                                    vector<uint32_t>& outEdges) {
+    switch (queue_) {
+    case QueueKind::FOUR_ARY_HEAP:
+        return dijkstraWith<IndexedFourAryHeap, Metric>(source, target, outEdges);
+    case QueueKind::RADIX_HEAP:
+        return dijkstraWith<RadixHeap, Metric>(source, target, outEdges);
+    case QueueKind::BUCKET_QUEUE:
+        if (std::is_same<Metric, TravelTimeMetric>::value)
+            return dijkstraWith<BucketQueue, TravelTimeMetric>(source, target, outEdges);
+        return dijkstraWith<IndexedFourAryHeap, Metric>(source, target, outEdges);
+    case QueueKind::BINARY_HEAP:
+    default:
+        return dijkstraWith<BinaryHeapQueue, Metric>(source, target, outEdges);
+    }
+}
+
+/**
+ * @brief Dijkstra một chiều trên CSR, dừng ngay khi đích được chốt.
+ *        Queue::INTEGER_KEYS: khoảng cách tính bằng 1/10 giây (số nguyên). Cung có
+ *        chi phí không hữu hạn bị bỏ qua; nếu hàng đợi từ chối một khóa (BucketQueue
+ *        gặp cung quá dài, vd. Edge tốc độ 0) thì chạy lại với heap 4-ngả.
+ */
+template <class Queue, class Metric>
+double ShortestPath::dijkstraWith(uint32_t source, uint32_t target,
+                                  vector<uint32_t>& outEdges) {
+
+    const CompactGraph& g = map_.graph();
+    // weight là giờ; 36000 phần mười giây trong một giờ
+    const double DECISECONDS_PER_HOUR = 36000.0;
+    const ClosureSet* closed = activeClosures();
+
+    // workspace và hàng đợi của luồng: không cấp phát, không khởi tạo lại O(N)
+    SearchWorkspace& ws = SearchWorkspace::forThread();
+    thread_local Queue queue;
+    ws.reset(g.numNodes());
+    queue.reset(g.numNodes());
+    ws.set(source, 0, CompactGraph::INVALID);
+    queue.push(0, source);
+
+    while (!queue.empty()) {
+        auto [d, u] = queue.pop();
+        if (d > ws.dist(u)) continue;
+        if (u == target) break;     // đích đã được chốt: dừng sớm
+
+        for (ArcView arc : g.outArcs(u)) {
+            if (closed && closed->contains(arc.edge)) continue;
+            double w = Metric::cost(g, arc);
+            if (!std::isfinite(w)) continue;
+            if (Queue::INTEGER_KEYS) w = std::round(w * DECISECONDS_PER_HOUR);
+            double nd = d + w;
+            if (nd < ws.dist(arc.target)) {
+                ws.set(arc.target, nd, arc.edge);
+                queue.push(nd, arc.target);
+            }
+        }
+        if (queue.overflowed()) break;
+    }
+
+    if (queue.overflowed())
+        return dijkstraWith<IndexedFourAryHeap, Metric>(source, target, outEdges);
+    if (!ws.reached(target)) return -1;
+
+    // truy vết đường theo Edge cha
+    for (uint32_t cur = target; cur != source; cur = g.tail[ws.parent(cur)])
+        outEdges.push_back(ws.parent(cur));
+
+    // đảo ngược thứ tự để từ source -> target
+    std::reverse(outEdges.begin(), outEdges.end());
+
+    if (!Queue::INTEGER_KEYS) return ws.dist(target);
+    double total = 0;
+    for (uint32_t a : outEdges) total += Metric::cost(g, ArcView{g.head[a], g.weight[a], a});
+    return total;
+}
+
+/**
+ * @brief Dijkstra trên cung: nhãn gắn với Edge vừa đi qua (tới head của Edge), nên
+ *        chi phí rẽ phụ thuộc cặp (Edge vào, Edge ra) được cộng khi nới lỏng mà không
+ *        cần dựng đồ thị đường (line graph). Workspace đánh số theo chỉ số Edge.
+ */
+double ShortestPath::edgeBasedDijkstra(uint32_t source, uint32_t target,
+                                       vector<uint32_t>& outEdges) {
+
+    const CompactGraph& g = map_.graph();
+    if (source == target) return 0;
+    const ClosureSet* closed = activeClosures();
+
+    SearchWorkspace& ws = SearchWorkspace::forThread();
+    ws.reset(g.numEdges());
+    for (ArcView arc : g.outArcs(source)) {
+        if (closed && closed->contains(arc.edge)) continue;
+        if (arc.weight < ws.dist(arc.edge)) {
+            ws.set(arc.edge, arc.weight, CompactGraph::INVALID);
+            ws.push(arc.weight, arc.edge);
+        }
+    }
+
+    uint32_t last = CompactGraph::INVALID;
+    while (!ws.empty()) {
+        auto [d, a] = ws.pop();
+        if (d > ws.dist(a)) continue;
+        uint32_t v = g.head[a];
+        if (v == target) {
+            last = a;
+            break;
+        }
+
+        for (ArcView arc : g.outArcs(v)) {
+            if (closed && closed->contains(arc.edge)) continue;
+            double nd = d + arc.weight + g.turnCost(a, arc.edge);
+            if (nd < ws.dist(arc.edge)) {
+                ws.set(arc.edge, nd, a);
+                ws.push(nd, arc.edge);
+            }
+        }
+    }
+
+    if (last == CompactGraph::INVALID) return -1;
+
+    for (uint32_t a = last; a != CompactGraph::INVALID; a = ws.parent(a))
+        outEdges.push_back(a);
+    std::reverse(outEdges.begin(), outEdges.end());
+
+    return ws.dist(last);
+}
+
+/**
+ * @brief Dijkstra chỉ nới lỏng các cung có cờ của vùng chứa đích: mọi đường ngắn
+ *        nhất tới đích đều nằm trên các cung đó, nên kết quả trùng Dijkstra.
+ */
+double ShortestPath::arcFlagsSearch(uint32_t source, uint32_t target,
+                                    vector<uint32_t>& outEdges) {
+
+    const CompactGraph& g = map_.graph();
+    const ArcFlags& flags = *arcFlags_;
+    const uint32_t goalRegion = flags.region(target);
+
+    SearchWorkspace& ws = SearchWorkspace::forThread();
+    ws.reset(g.numNodes());
+    ws.set(source, 0, CompactGraph::INVALID);
+    ws.push(0, source);
+
+    while (!ws.empty()) {
+        auto [d, u] = ws.pop();
+        if (d > ws.dist(u)) continue;
+        if (u == target) break;
+
+        for (ArcView arc : g.outArcs(u)) {
+            if (!flags.flag(arc.edge, goalRegion)) continue;
+            double nd = d + arc.weight;
+            if (nd < ws.dist(arc.target)) {
+                ws.set(arc.target, nd, arc.edge);
+                ws.push(nd, arc.target);
+            }
+        }
+    }
+
+    if (!ws.reached(target)) return -1;
+
+    for (uint32_t cur = target; cur != source; cur = g.tail[ws.parent(cur)])
+        outEdges.push_back(ws.parent(cur));
+    std::reverse(outEdges.begin(), outEdges.end());
+
+    return ws.dist(target);
+}
+
+/**
+ * @brief Dijkstra hai chiều: tìm xuôi từ source trên outArcs và tìm ngược từ
+ *        target trên inArcs, luôn mở rộng phía có khóa nhỏ hơn. Dừng khi tổng hai
+ *        khóa nhỏ nhất không còn nhỏ hơn độ dài đường tốt nhất đã gặp (mu).
+ */
+double ShortestPath::bidirectionalDijkstra(uint32_t source, uint32_t target,
+                                           vector<uint32_t>& outEdges) {
+
+    const CompactGraph& g = map_.graph();
+    const double INF = numeric_limits<double>::infinity();
+
+    SearchWorkspace& fw = SearchWorkspace::forThread(0);
+    SearchWorkspace& bw = SearchWorkspace::forThread(1);
+    fw.reset(g.numNodes());
+    bw.reset(g.numNodes());
+    fw.set(source, 0, CompactGraph::INVALID);
+    bw.set(target, 0, CompactGraph::INVALID);
+    fw.push(0, source);
+    bw.push(0, target);
+
+    double mu = (source == target) ? 0 : INF;
+    uint32_t meet = (source == target) ? source : CompactGraph::INVALID;
+
+    while (!fw.empty() && !bw.empty()) {
+        if (fw.topKey() + bw.topKey() >= mu) break;
+
+        bool forward = fw.topKey() <= bw.topKey();
+        SearchWorkspace& ws = forward ? fw : bw;
+        SearchWorkspace& other = forward ? bw : fw;
+
+        auto [d, u] = ws.pop();
+        if (d > ws.dist(u)) continue;
+
+        auto relax = [&](const ArcView& arc) {
+            double nd = d + arc.weight;
+            if (nd < ws.dist(arc.target)) {
+                ws.set(arc.target, nd, arc.edge);
+                ws.push(nd, arc.target);
+            }
+            // nối hai nửa đường qua node vừa chạm
+            if (other.reached(arc.target) && nd + other.dist(arc.target) < mu) {
+                mu = nd + other.dist(arc.target);
+                meet = arc.target;
+            }
+        };
+
+        if (forward) {
+            for (ArcView arc : g.outArcs(u)) relax(arc);
+        } else {
+            for (ArcView arc : g.inArcs(u)) relax(arc);
+        }
+    }
+
+    if (meet == CompactGraph::INVALID) return -1;
+
+    // nửa đầu: truy vết xuôi từ meet về source
+    for (uint32_t cur = meet; cur != source; cur = g.tail[fw.parent(cur)])
+        outEdges.push_back(fw.parent(cur));
+    std::reverse(outEdges.begin(), outEdges.end());
+
+    // nửa sau: truy vết ngược từ meet tới target
+    for (uint32_t cur = meet; cur != target; cur = g.head[bw.parent(cur)])
+        outEdges.push_back(bw.parent(cur));
+
+    return mu;
+}
+
+/**
+ * @brief A* tổng quát với heuristic nhất quán h (h(target) = 0). Kết quả trùng
+ *        với Dijkstra; chỉ khác ở số node phải mở rộng.
+ */
+template <class Heuristic>
+double ShortestPath::astarSearch(uint32_t source, uint32_t target,
+                                 vector<uint32_t>& outEdges, const Heuristic& h) {
+
+    const CompactGraph& g = map_.graph();
+
+    SearchWorkspace& ws = SearchWorkspace::forThread();
+    ws.reset(g.numNodes());
+    ws.set(source, 0, CompactGraph::INVALID);
+    ws.push(h(source), source);
+
+    while (!ws.empty()) {
+        auto [key, u] = ws.pop();
+        double d = ws.dist(u);
+        if (key > d + h(u)) continue;   // mục cũ trong heap
+        if (u == target) break;
+
+        for (ArcView arc : g.outArcs(u)) {
+            double nd = d + arc.weight;
+            if (nd < ws.dist(arc.target)) {
+                ws.set(arc.target, nd, arc.edge);
+                ws.push(nd + h(arc.target), arc.target);
+            }
+        }
+    }
+
+    if (!ws.reached(target)) return -1;
+
+    for (uint32_t cur = target; cur != source; cur = g.tail[ws.parent(cur)])
+        outEdges.push_back(ws.parent(cur));
+    std::reverse(outEdges.begin(), outEdges.end());
+
+    return ws.dist(target);
+}
+
+/**
+ * @brief A* với heuristic h(v) = minTimePerKm * haversine(v, target).
+ *        minTimePerKm không vượt quá weight/haversine của bất kỳ Edge nào nên h
+ *        nhất quán (consistent); kết quả trùng với Dijkstra. Hệ số được nhân thêm
+ *        (1 - 1e-9) để sai số dấu phẩy động không phá vỡ tính nhất quán.
+ */
+double ShortestPath::astar(uint32_t source, uint32_t target,
+                           vector<uint32_t>& outEdges) {
+
+    const CompactGraph& g = map_.graph();
+    const double factor = g.minTimePerKm * (1 - 1e-9);
+    const double tLat = g.lat[target], tLon = g.lon[target];
+    auto h = [&](uint32_t v) {
+        return factor * haversineKm(g.lat[v], g.lon[v], tLat, tLon);
+    };
+    return astarSearch(source, target, outEdges, h);
+}
+
+/**
+ * @brief ALT: A* với cận dưới từ bảng landmark. Bảng được tính trên đồ thị không
+ *        chặn nên vẫn đúng khi đang có Edge bị chặn. Lùi về A* hình học nếu chưa
+ *        có bảng hoặc bảng đã cũ so với graph().
+ */
+double ShortestPath::alt(uint32_t source, uint32_t target,
+                         vector<uint32_t>& outEdges) {
 
-    // đảo ngược thứ tự để từ start -> goal
-    std::reverse(outPath.begin(), outPath.end());
+    const CompactGraph& g = map_.graph();
+    if (!landmarks_ || !landmarks_->isValidFor(g))
+        return astar(source, target, outEdges);
 
-    return dist[goal];
+    const LandmarkIndex& lm = *landmarks_;
+    auto h = [&](uint32_t v) {
+        return lm.lowerBound(v, target) * (1 - 1e-9);
+    };
+    return astarSearch(source, target, outEdges, h);
 }
@@ -1,8 +1,77 @@
 #pragma once
 #include "RoadMap.h"
+#include "Landmarks.h"
+#include "ContractionHierarchy.h"
+#include "CustomizableCH.h"
+#include "HubLabels.h"
+#include "DeltaStepping.h"
+#include "ArcFlags.h"
+#include "ClosureSet.h"
+#include "Metrics.h"
+#include <cstdint>
 #include <string>
 #include <vector>
 
+// Thuật toán dùng cho truy vấn điểm - điểm
+enum class RoutingAlgorithm {
+    DIJKSTRA,           // Dijkstra một chiều, dừng khi chốt được đích
+    BIDIRECTIONAL,      // Dijkstra hai chiều trên chỉ mục cung xuôi/ngược
+    ASTAR,              // A* với cận dưới haversine * minTimePerKm
+    ALT,                // A* với cận dưới landmark (cần setLandmarks)
+    CONTRACTION_HIERARCHY,  // truy vấn trên phân cấp đã tiền xử lý (cần setContractionHierarchy)
+    CUSTOMIZABLE_CH,        // CCH đã customize (cần setCustomizableCH)
+    ARC_FLAGS               // Dijkstra chỉ đi trên Edge có cờ vùng đích (cần setArcFlags)
+};
+
+// Hàng đợi ưu tiên cho chế độ DIJKSTRA (xem PriorityQueues.h)
+enum class QueueKind {
+    BINARY_HEAP,        // heap nhị phân xóa lười
+    FOUR_ARY_HEAP,      // heap 4-ngả có chỉ mục, decrease-key
+    RADIX_HEAP,         // radix heap trên mẫu bit của khóa double
+    BUCKET_QUEUE        // bucket Dial trên weight lượng tử hóa theo 1/10 giây
+};
+
+// Tuyến theo từng Edge: mỗi bước là chỉ số Edge của graph() và thời gian đi tích lũy
+// (giờ, kể cả chi phí rẽ) khi tới cuối Edge đó. Giữ đúng Edge đã chọn khi hai node
+// nối bằng nhiều đường song song.
+struct RouteStep {
+    uint32_t edge;
+    double time;
+};
+
+struct EdgeRoute {
+    uint32_t source = CompactGraph::INVALID;
+    double cost = -1;                       // giá trị findShortestPath trả về, -1 nếu không có đường
+    std::vector<RouteStep> steps;
+
+    bool found() const { return cost >= 0; }
+    double travelTime() const { return steps.empty() ? 0 : steps.back().time; }
+    // Dãy ID node từ nguồn tới đích
+    std::vector<std::string> nodePath(const CompactGraph& g) const;
+    // Giữ lại dung lượng để các lần gọi sau không cấp phát
+    void clear() { source = CompactGraph::INVALID; cost = -1; steps.clear(); }
+};
+
+// Kết quả tìm kiếm một - tất cả có giới hạn thời gian (isochrone).
+// Thời gian cùng đơn vị với Edge::travelTime() (giờ).
+struct IsochroneResult {
+    struct ReachedNode {
+        uint32_t node;      // chỉ số node trong graph()
+        double time;        // thời điểm tới sớm nhất, <= budget
+    };
+    struct BoundaryEdge {
+        uint32_t edge;      // chỉ số Edge: node nguồn tới được, node đích vượt ngân sách qua Edge này
+        double fraction;    // phần Edge đi được trong ngân sách, trong [0, 1)
+    };
+
+    double budget = 0;
+    std::vector<ReachedNode> nodes;         // theo thứ tự thời gian tăng dần
+    std::vector<BoundaryEdge> boundary;
+
+    // Giữ lại dung lượng để các lần gọi sau không cấp phát
+    void clear() { nodes.clear(); boundary.clear(); }
+};
+
 class ShortestPath {
 public:
     ShortestPath(RoadMap& map);
@@ -10,6 +79,127 @@ public:
                             const std::string& goal,
                             std::vector<std::string>& outPath);
 
+    // Phiên bản theo chỉ số của graph(): trả về dãy chỉ số Edge từ source tới target
+    double findShortestPath(uint32_t source, uint32_t target,
+                            std::vector<uint32_t>& outEdges);
+
+    // Như trên nhưng trả về tuyến theo Edge kèm thời gian tích lũy (xem EdgeRoute)
+    double findRoute(const std::string& start, const std::string& goal, EdgeRoute& out);
+    double findRoute(uint32_t source, uint32_t target, EdgeRoute& out);
+
+    // Tìm đường phụ thuộc thời gian: khởi hành lúc departure (giờ kể từ 0h, có thể
+    // lớn hơn 24), mỗi Edge tính theo profile tại thời điểm đi vào Edge (xem
+    // RoadMap::setEdgeProfile). Trả về thời gian đi (đến nơi - khởi hành), -1 nếu
+    // không có đường. Chế độ ASTAR/ALT dùng A* với cận dưới hình học nhân hệ số
+    // profile nhỏ nhất; các chế độ khác dùng Dijkstra. Luôn theo thời gian (bỏ qua metric).
+    double findShortestPathAt(const std::string& start, const std::string& goal,
+                              double departure, std::vector<std::string>& outPath);
+    double findShortestPathAt(uint32_t source, uint32_t target, double departure,
+                              std::vector<uint32_t>& outEdges);
+
+    // Chỉ cần thời gian đi, không cần đường: dùng hub label nếu có và còn khớp,
+    // nếu không thì chạy thuật toán hiện tại. Trả về -1 nếu không có đường.
+    double travelTime(const std::string& start, const std::string& goal);
+    double travelTime(uint32_t source, uint32_t target);
+
+    // Mọi node tới được từ source trong thời gian budget, kèm các Edge biên.
+    // Dùng workspace của luồng và vector của out, nên gọi lặp lại không cấp phát.
+    // Trả về false nếu source không tồn tại.
+    bool isochrone(const std::string& start, double budget, IsochroneResult& out);
+    bool isochrone(uint32_t source, double budget, IsochroneResult& out);
+
+    // Thời gian đi từ source tới mọi node (-1 nếu không tới được) cho phân tích toàn
+    // mạng, chạy delta-stepping song song (xem deltaStepping() để chỉnh số luồng và
+    // độ rộng bucket). Luôn theo thời gian, bỏ qua chi phí rẽ. false nếu source không tồn tại.
+    bool travelTimesFrom(const std::string& start, std::vector<double>& out);
+    bool travelTimesFrom(uint32_t source, std::vector<double>& out);
+    DeltaStepping& deltaStepping() { return deltaStepping_; }
+
+    void setAlgorithm(RoutingAlgorithm algorithm) { algorithm_ = algorithm; }
+    RoutingAlgorithm getAlgorithm() const { return algorithm_; }
+
+    // Hàng đợi dùng cho DIJKSTRA. BUCKET_QUEUE tìm trên weight làm tròn tới 1/10 giây
+    // nên có thể chọn một đường lệch tối đa sai số làm tròn; thời gian trả về vẫn là
+    // tổng weight thực của đường đã chọn. Gặp cung dài hơn BucketQueue::MAX_SPAN
+    // (vd. Edge tốc độ 0) thì truy vấn đó chạy lại bằng heap 4-ngả.
+    void setQueue(QueueKind queue) { queue_ = queue; }
+    QueueKind getQueue() const { return queue_; }
+
+    // Hàm chi phí (xem Metrics.h). Mọi tiền xử lý (landmark, CH, CCH, hub label) và
+    // heuristic A* đều tính theo thời gian, nên với hàm chi phí khác TRAVEL_TIME mọi
+    // chế độ đều chạy Dijkstra một chiều; BUCKET_QUEUE khi đó dùng heap 4-ngả.
+    // Giá trị trả về của findShortestPath là tổng chi phí theo hàm đã chọn.
+    // Khi bản đồ có chi phí rẽ (RoadMap::setTurnCost / setUTurnPenalty) và hàm chi phí
+    // là thời gian, findShortestPath / travelTime chạy Dijkstra trên cung (trạng thái =
+    // Edge vừa đi qua) bất kể thuật toán đã chọn. Không có chi phí rẽ thì vẫn chạy tìm
+    // kiếm theo node như trước. Isochrone và tìm đường theo giờ khởi hành bỏ qua chi phí rẽ.
+    void setMetric(MetricKind metric) { metric_ = metric; }
+    // Chọn theo tên ("time", "distance", "budget", "avoid_highway", ...); false nếu không có
+    bool setMetric(const std::string& name) { return metricFromName(name, metric_); }
+    MetricKind getMetric() const { return metric_; }
+
+    // Bảng landmark cho chế độ ALT (không sở hữu). Nếu bảng không khớp với
+    // graph() hiện tại thì ALT lùi về A* hình học.
+    void setLandmarks(const LandmarkIndex* landmarks) { landmarks_ = landmarks; }
+
+    // Phân cấp cho chế độ CONTRACTION_HIERARCHY (không sở hữu). Phân cấp không biết
+    // Edge nào bị chặn, nên khi bản đồ đang chặn Edge, hoặc phân cấp đã cũ, truy vấn
+    // lùi về Dijkstra hai chiều.
+    void setContractionHierarchy(const ContractionHierarchy* ch) { ch_ = ch; }
+
+    // CCH cho chế độ CUSTOMIZABLE_CH (không sở hữu). Truy vấn dùng bộ trọng số của
+    // lần customize() gần nhất, kể cả Edge bị chặn tại thời điểm đó; gọi customize()
+    // sau khi đổi tốc độ hay chặn/bỏ chặn Edge. Chưa customize thì lùi về Dijkstra hai chiều.
+    void setCustomizableCH(const CustomizableCH* cch) { cch_ = cch; }
+
+    // Hub label cho travelTime() (không sở hữu). Như CH, nhãn bỏ qua Edge bị chặn nên
+    // không được dùng khi bản đồ đang chặn Edge.
+    void setHubLabels(const HubLabels* labels) { hubLabels_ = labels; }
+
+    // Arc flags cho chế độ ARC_FLAGS (không sở hữu). Khi bản đồ đang chặn Edge hoặc
+    // cờ đã cũ so với graph(), truy vấn lùi về Dijkstra.
+    void setArcFlags(const ArcFlags* flags) { arcFlags_ = flags; }
+
+    // Edge đóng thêm cho các truy vấn sau (không sở hữu, nullptr để bỏ), cộng với các
+    // Edge đang bị chặn trên bản đồ. Khi tập khác rỗng, findShortestPath / findRoute /
+    // travelTime chạy Dijkstra (trên node, hoặc trên cung nếu có chi phí rẽ) bất kể
+    // thuật toán đã chọn, vì CH, hub label và arc flags không biết Edge bị đóng;
+    // isochrone và tìm đường theo giờ khởi hành cũng bỏ qua Edge đóng, travelTimesFrom
+    // thì không. Tập dựng trên lần graph() khác (sau addEdge / loadFromFile) bị bỏ qua.
+    void setClosures(const ClosureSet* closures) { closures_ = closures; }
+
 private:
     RoadMap& map_;
+    RoutingAlgorithm algorithm_ = RoutingAlgorithm::DIJKSTRA;
+    QueueKind queue_ = QueueKind::BINARY_HEAP;
+    MetricKind metric_ = MetricKind::TRAVEL_TIME;
+    const LandmarkIndex* landmarks_ = nullptr;
+    const ContractionHierarchy* ch_ = nullptr;
+    const CustomizableCH* cch_ = nullptr;
+    const HubLabels* hubLabels_ = nullptr;
+    const ArcFlags* arcFlags_ = nullptr;
+    const ClosureSet* closures_ = nullptr;
+    DeltaStepping deltaStepping_;
+
+    // closures_ nếu đang có hiệu lực với graph(), nếu không thì nullptr
+    const ClosureSet* activeClosures() const;
+
+    double dijkstra(uint32_t source, uint32_t target, std::vector<uint32_t>& outEdges);
+    template <class Metric>
+    double dijkstraMetric(uint32_t source, uint32_t target, std::vector<uint32_t>& outEdges);
+    template <class Queue, class Metric>
+    double dijkstraWith(uint32_t source, uint32_t target, std::vector<uint32_t>& outEdges);
+    double edgeBasedDijkstra(uint32_t source, uint32_t target, std::vector<uint32_t>& outEdges);
+    double bidirectionalDijkstra(uint32_t source, uint32_t target, std::vector<uint32_t>& outEdges);
+    double astar(uint32_t source, uint32_t target, std::vector<uint32_t>& outEdges);
+    double arcFlagsSearch(uint32_t source, uint32_t target, std::vector<uint32_t>& outEdges);
+    double alt(uint32_t source, uint32_t target, std::vector<uint32_t>& outEdges);
+
+    template <class Heuristic>
+    double timeDependentSearch(uint32_t source, uint32_t target, double departure,
+                               std::vector<uint32_t>& outEdges, const Heuristic& h);
+
+    template <class Heuristic>
+    double astarSearch(uint32_t source, uint32_t target,
+                       std::vector<uint32_t>& outEdges, const Heuristic& h);
 };
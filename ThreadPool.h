@@ -0,0 +1,155 @@
+#pragma once
+#include "Parallel.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Thread pool có đánh cắp việc (work stealing): mỗi luồng có hàng đợi riêng,
+// lấy việc mới nhất của mình (LIFO, còn nóng trong cache) và khi hết việc thì lấy
+// việc cũ nhất từ hàng đợi của luồng khác (FIFO). Việc gửi từ ngoài pool được
+// rải vòng tròn lên các hàng đợi; việc gửi từ trong một worker vào hàng đợi của nó.
+// Mỗi hàng đợi có khóa riêng; số việc đang chờ và chưa xong là biến nguyên tử, nên
+// gửi và đánh cắp không tranh một khóa chung. Worker không tìm thấy việc thì ngủ
+// trên condition variable tới khi có việc mới.
+class ThreadPool {
+public:
+    // threads = 0: dùng std::thread::hardware_concurrency()
+    explicit ThreadPool(unsigned threads = 0) {
+        unsigned n = defaultThreadCount(threads);
+        for (unsigned i = 0; i < n; i++) queues_.push_back(std::make_unique<Queue>());
+        for (unsigned i = 0; i < n; i++) workers_.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(parkMutex_);
+            stop_.store(true);
+        }
+        wake_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+    void submit(std::function<void()> task) {
+        unsigned q = currentWorker() != NO_WORKER && owner() == this
+                         ? currentWorker()
+                         : nextQueue_.fetch_add(1, std::memory_order_relaxed) % size();
+        pending_.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+            queues_[q]->tasks.push_back(std::move(task));
+        }
+        queued_.fetch_add(1);
+        // Worker tăng sleepers_ rồi mới xem queued_, ở đây tăng queued_ rồi mới xem
+        // sleepers_: ít nhất một bên thấy bên kia nên không mất lần đánh thức
+        if (sleepers_.load() > 0) {
+            std::lock_guard<std::mutex> lock(parkMutex_);
+            wake_.notify_one();
+        }
+    }
+
+    // Chờ tới khi mọi việc đã gửi chạy xong (không gọi từ bên trong một worker)
+    void wait() {
+        std::unique_lock<std::mutex> lock(doneMutex_);
+        done_.wait(lock, [this] { return pending_.load() == 0; });
+    }
+
+private:
+    static constexpr unsigned NO_WORKER = ~0u;
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<unsigned> nextQueue_{0};
+
+    std::atomic<size_t> queued_{0};     // việc đang nằm trong các hàng đợi
+    std::atomic<size_t> pending_{0};    // việc chưa chạy xong
+    std::atomic<unsigned> sleepers_{0}; // worker đang ngủ hoặc sắp ngủ
+    std::atomic<bool> stop_{false};
+
+    std::mutex parkMutex_;
+    std::condition_variable wake_;
+    std::mutex doneMutex_;
+    std::condition_variable done_;
+
+    static unsigned& currentWorker() { thread_local unsigned id = NO_WORKER; return id; }
+    static const ThreadPool*& owner() { thread_local const ThreadPool* p = nullptr; return p; }
+
+    // Lấy một việc: hàng đợi của mình trước (cuối), rồi đánh cắp từ luồng khác (đầu)
+    bool tryTake(unsigned self, std::function<void()>& task) {
+        {
+            Queue& own = *queues_[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (unsigned k = 1; k < size(); k++) {
+            Queue& victim = *queues_[(self + k) % size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(unsigned self) {
+        currentWorker() = self;
+        owner() = this;
+        std::function<void()> task;
+        while (true) {
+            if (!tryTake(self, task)) {
+                std::unique_lock<std::mutex> lock(parkMutex_);
+                if (stop_.load() && queued_.load() == 0) return;
+                sleepers_.fetch_add(1);
+                wake_.wait(lock, [this] { return stop_.load() || queued_.load() > 0; });
+                sleepers_.fetch_sub(1);
+                continue;
+            }
+            queued_.fetch_sub(1);
+            task();
+            task = nullptr;
+            if (pending_.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(doneMutex_);
+                done_.notify_all();
+            }
+        }
+    }
+};
+
+// Như parallelFor trong Parallel.h nhưng dùng các worker của một pool có sẵn cùng
+// với luồng gọi, để vòng lặp chạy nhiều lần (mỗi vòng co, mỗi vùng, mỗi tầng) không
+// phải tạo luồng mới và mỗi luồng giữ nguyên SearchWorkspace của nó giữa các lần.
+// pool = nullptr: chạy tuần tự trên luồng gọi. Không gọi từ bên trong worker của pool.
+template <class F>
+void parallelFor(ThreadPool* pool, size_t count, F fn, size_t chunk = 64) {
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t b = next.fetch_add(chunk); b < count; b = next.fetch_add(chunk))
+            for (size_t i = b; i < std::min(count, b + chunk); i++) fn(i);
+    };
+    size_t chunks = (count + chunk - 1) / chunk;
+    size_t helpers = pool && chunks > 1 ? std::min<size_t>(pool->size(), chunks - 1) : 0;
+    for (size_t t = 0; t < helpers; t++) pool->submit(worker);
+    worker();
+    if (helpers) pool->wait();
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Profile thời gian đi tuyến tính từng khúc theo giờ trong ngày, dạng phẳng trong
+// CompactGraph. Các Edge cùng lớp profile dùng chung một dãy breakpoint (giờ trong
+// [0, 24)); mỗi Edge chỉ lưu hệ số nhân weight tại từng breakpoint cùng độ dốc của
+// từng đoạn đã tính sẵn, nên tính giá trị chỉ là một tìm kiếm nhị phân trên dãy
+// breakpoint ngắn và một phép nhân - cộng, không cấp phát.
+// Thời gian đi của Edge e khi vào Edge lúc t: weight[e] * factorAt(e, t).
+struct TimeProfiles {
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+    static constexpr double PERIOD = 24.0;
+
+    // Breakpoint của lớp c là breakpoints[classFirst[c] .. classFirst[c+1])
+    std::vector<uint32_t> classFirst;
+    std::vector<double> breakpoints;
+
+    // Theo chỉ số Edge; edgeClass = NONE: không có profile (hệ số luôn là 1)
+    std::vector<uint32_t> edgeClass;
+    std::vector<uint32_t> edgeFirst;    // vị trí đầu của Edge trong factor/slope
+
+    std::vector<double> factor;         // hệ số tại breakpoint i
+    std::vector<double> slope;          // độ dốc trên đoạn [b_i, b_{i+1}); đoạn cuối nối vòng tới b_0 + 24
+
+    double minFactor = 1;               // min(1, mọi hệ số): cho cận dưới của A*
+
+    bool empty() const { return factor.empty(); }
+
+    double factorAt(uint32_t edge, double time) const {
+        uint32_t c = edgeClass.empty() ? NONE : edgeClass[edge];
+        if (c == NONE) return 1;
+
+        const double* b = breakpoints.data() + classFirst[c];
+        const uint32_t k = classFirst[c + 1] - classFirst[c];
+        double t = time - PERIOD * std::floor(time / PERIOD);
+
+        // i = số breakpoint <= t; t trước breakpoint đầu thuộc đoạn vòng cuối
+        uint32_t i = static_cast<uint32_t>(std::upper_bound(b, b + k, t) - b);
+        uint32_t seg = i == 0 ? k - 1 : i - 1;
+        double x = i == 0 ? t + PERIOD - b[seg] : t - b[seg];
+        uint32_t p = edgeFirst[edge] + seg;
+        return factor[p] + slope[p] * x;
+    }
+};
@@ -121,9 +121,13 @@ double TrafficOptimization::analyzeNodeCongestion(const string& nodeId) {
     double totalFlow = 0;
     double totalCapacity = 0;
     
-    auto edges = map_.getEdges();
-    for (const auto& e : edges) {
-        if (e.dst == nodeId && !e.isReverse) {
+    const CompactGraph& g = map_.graph();
+    uint32_t node = g.findNode(nodeId);
+    if (node == CompactGraph::INVALID) return 0;
+    // duyệt thẳng mảng CSR: Edge bị chặn vẫn tính flow/capacity
+    for (uint32_t i = g.firstIn[node]; i < g.firstIn[node + 1]; i++) {
+        const Edge& e = map_.edgeAt(g.inEdge[i]);
+        if (!e.isReverse) {
             totalFlow += e.flow;
             totalCapacity += e.capacity;
         }
@@ -417,16 +421,18 @@ std::vector<std::string> TrafficOptimization::findAdjacentCongestedRoads(const E
     congestedPath.push_back(startEdge.id);
     
     // Find forward congested roads (from dst of current edge)
-    std::string currentNode = startEdge.dst;
-    auto edges = map_.getEdges();
+    const CompactGraph& g = map_.graph();
+    uint32_t currentNode = g.findNode(startEdge.dst);
     
     bool foundCongested = true;
     while (foundCongested) {
         foundCongested = false;
-        for (const auto& e : edges) {
-            if (e.src == currentNode && !e.isReverse && isOverCapacity(e)) {
+        // duyệt thẳng mảng CSR: Edge bị chặn mà quá tải vẫn nối tiếp chuỗi ùn tắc
+        for (uint32_t a = g.firstOut[currentNode]; a < g.firstOut[currentNode + 1]; a++) {
+            const Edge& e = map_.edgeAt(a);
+            if (!e.isReverse && isOverCapacity(e)) {
                 congestedPath.push_back(e.id);
-                currentNode = e.dst;
+                currentNode = g.head[a];
                 foundCongested = true;
                 break;
             }
@@ -434,14 +440,16 @@ std::vector<std::string> TrafficOptimization::findAdjacentCongestedRoads(const E
     }
     
     // Find backward congested roads (from src of current edge)
-    currentNode = startEdge.src;
+    currentNode = g.findNode(startEdge.src);
     foundCongested = true;
     while (foundCongested) {
         foundCongested = false;
-        for (const auto& e : edges) {
-            if (e.dst == currentNode && !e.isReverse && isOverCapacity(e)) {
+        for (uint32_t i = g.firstIn[currentNode]; i < g.firstIn[currentNode + 1]; i++) {
+            uint32_t a = g.inEdge[i];
+            const Edge& e = map_.edgeAt(a);
+            if (!e.isReverse && isOverCapacity(e)) {
                 congestedPath.insert(congestedPath.begin(), e.id);
-                currentNode = e.src;
+                currentNode = g.tail[a];
                 foundCongested = true;
                 break;
             }
@@ -488,20 +496,20 @@ NewRoadProposal TrafficOptimization::createDirectBypassProposal(const std::vecto
     // Calculate total cost of congested roads
     double totalCost = 0;
     double totalFlow = 0;
-    auto edges = map_.getEdges();
+    const CompactGraph& g = map_.graph();
     
     std::string firstNode, lastNode;
     for (const auto& edgeId : congestedPath) {
-        for (const auto& e : edges) {
-            if (e.id == edgeId && !e.isReverse) {
-                totalCost += e.budget;
-                totalFlow += e.flow;
-                if (firstNode.empty()) {
-                    firstNode = e.src;
-                }
-                lastNode = e.dst;
-                break;
+        uint32_t a = g.findEdge(edgeId);
+        if (a == CompactGraph::INVALID) continue;
+        const Edge& e = map_.edgeAt(a);
+        if (!e.isReverse) {
+            totalCost += e.budget;
+            totalFlow += e.flow;
+            if (firstNode.empty()) {
+                firstNode = e.src;
             }
+            lastNode = e.dst;
         }
     }
     
@@ -689,3 +697,28 @@ std::vector<std::string> TrafficOptimization::getTrafficSignalSolutions(const Ed
     
     return solutions;
 }
+
+AccessibilityInfo TrafficOptimization::analyzeAccessibility(const std::string& nodeId, unsigned threads) {
+    AccessibilityInfo info;
+    info.nodeId = nodeId;
+    info.reachableNodes = 0;
+    info.averageTime = 0;
+    info.maxTime = 0;
+
+    ShortestPath sp(map_);
+    sp.deltaStepping().setThreads(threads);
+    vector<double> times;
+    if (!sp.travelTimesFrom(nodeId, times)) return info;
+
+    uint32_t self = map_.graph().findNode(nodeId);
+    double total = 0;
+    for (uint32_t v = 0; v < times.size(); v++) {
+        double t = times[v];
+        if (t < 0 || v == self) continue;
+        info.reachableNodes++;
+        total += t;
+        info.maxTime = max(info.maxTime, t);
+    }
+    if (info.reachableNodes > 0) info.averageTime = total / info.reachableNodes;
+    return info;
+}
@@ -44,6 +44,14 @@ struct TrafficOptimizationResult {
     std::vector<std::string> trafficSignalSolutions;  // Giải pháp không cần ngân sách
 };
 
+// Mức tiếp cận của một node: thời gian đi tới các node khác trên toàn mạng
+struct AccessibilityInfo {
+    std::string nodeId;
+    size_t reachableNodes;      // không tính chính node đó
+    double averageTime;         // giờ, trung bình trên các node tới được
+    double maxTime;             // giờ
+};
+
 class TrafficOptimization {
 public: 
     TrafficOptimization(RoadMap& map);
@@ -55,6 +63,11 @@ public:
     std::vector<CongestionInfo> getCongestedRoads();
     TrafficOptimizationResult analyzeCongestedRoad(const std::string& edgeId, double budget);
 
+    // Thời gian đi từ nodeId tới toàn mạng (một - tất cả bằng delta-stepping song song).
+    // threads = 0: dùng std::thread::hardware_concurrency(). reachableNodes = 0 nếu
+    // node không tồn tại hoặc không đi được đâu.
+    AccessibilityInfo analyzeAccessibility(const std::string& nodeId, unsigned threads = 0);
+
 private:
     RoadMap& map_;
     
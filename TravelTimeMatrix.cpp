@@ -0,0 +1,224 @@
+#include "TravelTimeMatrix.h"
+#include "SearchWorkspace.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+namespace {
+    const double INF = numeric_limits<double>::infinity();
+    const uint32_t NONE = CompactGraph::INVALID;
+
+    struct BucketEntry {
+        uint32_t node;
+        uint32_t column;
+        double dist;
+    };
+
+    /**
+     * @brief Tìm kiếm hướng lên đầy đủ (không có điều kiện dừng theo đích).
+     *        visit(u, d) được gọi một lần cho mỗi node được chốt.
+     */
+    template <class ArcsOf, class Visit>
+    void upwardSearch(uint32_t n, uint32_t start, ArcsOf arcsOf, Visit visit) {
+        SearchWorkspace& ws = SearchWorkspace::forThread();
+        ws.reset(n);
+        ws.set(start, 0, NONE);
+        ws.push(0, start);
+        while (!ws.empty()) {
+            auto [d, u] = ws.pop();
+            if (d > ws.dist(u)) continue;
+            visit(u, d);
+            for (const CHArc& arc : arcsOf(u)) {
+                double nd = d + arc.weight;
+                if (nd < ws.dist(arc.node)) {
+                    ws.set(arc.node, nd, arc.id);
+                    ws.push(nd, arc.node);
+                }
+            }
+        }
+    }
+}
+
+TravelTimeMatrix::TravelTimeMatrix(RoadMap& map) : map_(map) {}
+
+vector<double> TravelTimeMatrix::compute(const vector<string>& sources,
+                                         const vector<string>& targets) {
+    const CompactGraph& g = map_.graph();
+    vector<uint32_t> s(sources.size()), t(targets.size());
+    for (size_t i = 0; i < sources.size(); i++) s[i] = g.findNode(sources[i]);
+    for (size_t j = 0; j < targets.size(); j++) t[j] = g.findNode(targets[j]);
+    return compute(s, t);
+}
+
+vector<double> TravelTimeMatrix::compute(const vector<uint32_t>& sources,
+                                         const vector<uint32_t>& targets) {
+    // dựng graph() trước khi chia luồng: các luồng chỉ đọc
+    const CompactGraph& g = map_.graph();
+    vector<double> out(sources.size() * targets.size(), -1);
+    if (out.empty()) return out;
+
+    if (g.hasTurnCosts())
+        oneToAllTurns(g, sources, targets, out);
+    else if (ch_ && ch_->isValidFor(g) && !map_.hasBlockedEdges())
+        buckets(sources, targets, out);
+    else
+        oneToAll(g, sources, targets, out);
+    return out;
+}
+
+/**
+ * @brief Mỗi nguồn một Dijkstra; dừng khi mọi node đích (khác nhau) đã được chốt.
+ */
+void TravelTimeMatrix::oneToAll(const CompactGraph& g, const vector<uint32_t>& sources,
+                                const vector<uint32_t>& targets, vector<double>& out) const {
+    const uint32_t n = g.numNodes();
+    const size_t cols = targets.size();
+
+    // node đích -> các cột của nó (một node có thể xuất hiện nhiều lần trong targets)
+    vector<uint32_t> columnFirst(n + 1, 0), columns;
+    uint32_t distinctTargets = 0;
+    for (uint32_t t : targets)
+        if (t < n && columnFirst[t + 1]++ == 0) distinctTargets++;
+    for (uint32_t v = 0; v < n; v++) columnFirst[v + 1] += columnFirst[v];
+    columns.resize(columnFirst[n]);
+    vector<uint32_t> pos(columnFirst.begin(), columnFirst.end() - 1);
+    for (size_t j = 0; j < cols; j++)
+        if (targets[j] < n) columns[pos[targets[j]]++] = static_cast<uint32_t>(j);
+
+    parallelFor(sources.size(), defaultThreadCount(threads_), [&](size_t i) {
+        uint32_t s = sources[i];
+        if (s >= n || distinctTargets == 0) return;
+        double* row = out.data() + i * cols;
+
+        SearchWorkspace& ws = SearchWorkspace::forThread();
+        ws.reset(n);
+        ws.set(s, 0, NONE);
+        ws.push(0, s);
+        uint32_t remaining = distinctTargets;
+        while (!ws.empty()) {
+            auto [d, u] = ws.pop();
+            if (d > ws.dist(u)) continue;
+            if (columnFirst[u] != columnFirst[u + 1]) {
+                for (uint32_t c = columnFirst[u]; c < columnFirst[u + 1]; c++) row[columns[c]] = d;
+                if (--remaining == 0) break;
+            }
+            for (ArcView arc : g.outArcs(u)) {
+                double nd = d + arc.weight;
+                if (nd < ws.dist(arc.target)) {
+                    ws.set(arc.target, nd, arc.edge);
+                    ws.push(nd, arc.target);
+                }
+            }
+        }
+    }, 1);
+}
+
+/**
+ * @brief Như oneToAll nhưng nhãn gắn với Edge vừa đi qua để cộng chi phí rẽ.
+ *        Ô của đích còn -1 nghĩa là đích chưa được chốt.
+ */
+void TravelTimeMatrix::oneToAllTurns(const CompactGraph& g, const vector<uint32_t>& sources,
+                                     const vector<uint32_t>& targets, vector<double>& out) const {
+    const uint32_t n = g.numNodes();
+    const size_t cols = targets.size();
+
+    vector<uint32_t> columnFirst(n + 1, 0), columns;
+    uint32_t distinctTargets = 0;
+    for (uint32_t t : targets)
+        if (t < n && columnFirst[t + 1]++ == 0) distinctTargets++;
+    for (uint32_t v = 0; v < n; v++) columnFirst[v + 1] += columnFirst[v];
+    columns.resize(columnFirst[n]);
+    vector<uint32_t> pos(columnFirst.begin(), columnFirst.end() - 1);
+    for (size_t j = 0; j < cols; j++)
+        if (targets[j] < n) columns[pos[targets[j]]++] = static_cast<uint32_t>(j);
+
+    parallelFor(sources.size(), defaultThreadCount(threads_), [&](size_t i) {
+        uint32_t s = sources[i];
+        if (s >= n || distinctTargets == 0) return;
+        double* row = out.data() + i * cols;
+
+        auto settle = [&](uint32_t u, double d) {
+            if (columnFirst[u] == columnFirst[u + 1] || row[columns[columnFirst[u]]] >= 0) return false;
+            for (uint32_t c = columnFirst[u]; c < columnFirst[u + 1]; c++) row[columns[c]] = d;
+            return true;
+        };
+
+        uint32_t remaining = distinctTargets;
+        if (settle(s, 0) && --remaining == 0) return;
+
+        SearchWorkspace& ws = SearchWorkspace::forThread();
+        ws.reset(g.numEdges());
+        for (ArcView arc : g.outArcs(s)) {
+            if (arc.weight < ws.dist(arc.edge)) {
+                ws.set(arc.edge, arc.weight, NONE);
+                ws.push(arc.weight, arc.edge);
+            }
+        }
+        while (!ws.empty()) {
+            auto [d, a] = ws.pop();
+            if (d > ws.dist(a)) continue;
+            uint32_t u = g.head[a];
+            if (settle(u, d) && --remaining == 0) break;
+            for (ArcView arc : g.outArcs(u)) {
+                double nd = d + arc.weight + g.turnCost(a, arc.edge);
+                if (nd < ws.dist(arc.edge)) {
+                    ws.set(arc.edge, nd, a);
+                    ws.push(nd, arc.edge);
+                }
+            }
+        }
+    }, 1);
+}
+
+/**
+ * @brief Thuật toán bucket trên CH: d(s, t) = min trên node u chung của không gian
+ *        tìm kiếm hướng lên của s và t của df(u) + db(u).
+ */
+void TravelTimeMatrix::buckets(const vector<uint32_t>& sources,
+                               const vector<uint32_t>& targets, vector<double>& out) const {
+    const uint32_t n = ch_->numNodes();
+    const size_t cols = targets.size();
+    const unsigned threads = defaultThreadCount(threads_);
+
+    // 1. Tìm kiếm ngược từ mỗi đích, mục bucket gom vào danh sách riêng của đích đó
+    vector<vector<BucketEntry>> perTarget(cols);
+    parallelFor(cols, threads, [&](size_t j) {
+        uint32_t t = targets[j];
+        if (t >= n) return;
+        upwardSearch(n, t, [&](uint32_t u) { return ch_->downArcs(u); },
+                     [&](uint32_t u, double d) {
+                         perTarget[j].push_back({u, static_cast<uint32_t>(j), d});
+                     });
+    }, 1);
+
+    // 2. Bucket dạng CSR theo node
+    vector<uint32_t> bucketFirst(n + 1, 0);
+    for (const auto& list : perTarget)
+        for (const BucketEntry& e : list) bucketFirst[e.node + 1]++;
+    for (uint32_t v = 0; v < n; v++) bucketFirst[v + 1] += bucketFirst[v];
+    vector<pair<uint32_t, double>> bucket(bucketFirst[n]);
+    vector<uint32_t> pos(bucketFirst.begin(), bucketFirst.end() - 1);
+    for (auto& list : perTarget) {
+        for (const BucketEntry& e : list) bucket[pos[e.node]++] = {e.column, e.dist};
+        vector<BucketEntry>().swap(list);
+    }
+
+    // 3. Tìm kiếm xuôi từ mỗi nguồn, mỗi luồng ghi hàng riêng của nó
+    parallelFor(sources.size(), threads, [&](size_t i) {
+        uint32_t s = sources[i];
+        if (s >= n) return;
+        double* row = out.data() + i * cols;
+        fill(row, row + cols, INF);
+        upwardSearch(n, s, [&](uint32_t u) { return ch_->upArcs(u); },
+                     [&](uint32_t u, double d) {
+                         for (uint32_t b = bucketFirst[u]; b < bucketFirst[u + 1]; b++) {
+                             double c = d + bucket[b].second;
+                             if (c < row[bucket[b].first]) row[bucket[b].first] = c;
+                         }
+                     });
+        for (size_t j = 0; j < cols; j++)
+            if (row[j] == INF) row[j] = -1;
+    }, 1);
+}
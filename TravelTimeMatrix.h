@@ -0,0 +1,46 @@
+#pragma once
+#include "RoadMap.h"
+#include "ContractionHierarchy.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Ma trận thời gian đi nhiều - nhiều (OD matrix) cho điều phối.
+// Kết quả là mảng phẳng theo hàng: values[i * targets.size() + j] = d(sources[i], targets[j]),
+// -1 nếu không có đường hoặc ID không tồn tại.
+// - Mặc định: Dijkstra một - tất cả cho mỗi nguồn, dừng khi đã chốt hết các đích;
+//   các nguồn chia cho nhiều luồng, mỗi luồng dùng lại SearchWorkspace của nó.
+// - Nếu có Contraction Hierarchy còn khớp và không Edge nào bị chặn: thuật toán
+//   bucket. Mỗi đích chạy một tìm kiếm ngược hướng lên và gửi (đích, khoảng cách)
+//   vào bucket của các node đã chốt; mỗi nguồn chạy một tìm kiếm xuôi hướng lên
+//   và quét bucket của các node nó chốt.
+// - Nếu bản đồ có chi phí rẽ: Dijkstra một - tất cả trên cung (như
+//   ShortestPath::edgeBasedDijkstra); đích được chốt ở Edge đầu tiên đi vào nó.
+class TravelTimeMatrix {
+public:
+    TravelTimeMatrix(RoadMap& map);
+
+    // threads = 0: dùng std::thread::hardware_concurrency()
+    void setThreads(unsigned threads) { threads_ = threads; }
+    // Phân cấp cho thuật toán bucket (không sở hữu)
+    void setContractionHierarchy(const ContractionHierarchy* ch) { ch_ = ch; }
+
+    std::vector<double> compute(const std::vector<std::string>& sources,
+                                const std::vector<std::string>& targets);
+
+    // Phiên bản theo chỉ số node của graph(); chỉ số INVALID cho ra -1
+    std::vector<double> compute(const std::vector<uint32_t>& sources,
+                                const std::vector<uint32_t>& targets);
+
+private:
+    RoadMap& map_;
+    unsigned threads_ = 0;
+    const ContractionHierarchy* ch_ = nullptr;
+
+    void oneToAll(const CompactGraph& g, const std::vector<uint32_t>& sources,
+                  const std::vector<uint32_t>& targets, std::vector<double>& out) const;
+    void oneToAllTurns(const CompactGraph& g, const std::vector<uint32_t>& sources,
+                       const std::vector<uint32_t>& targets, std::vector<double>& out) const;
+    void buckets(const std::vector<uint32_t>& sources,
+                 const std::vector<uint32_t>& targets, std::vector<double>& out) const;
+};
@@ -0,0 +1,105 @@
+// benchmark_queues.cpp - so sánh các hàng đợi ưu tiên của ShortestPath (chế độ DIJKSTRA)
+// Cách dùng: ./benchmark_queues [file bản đồ ...]
+// Không truyền file: chạy trên các lưới tổng hợp nhiều kích thước.
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "RoadMap.h"
+#include "ShortestPath.h"
+
+using namespace std;
+
+/**
+ * @brief Lưới W x H giống mạng đường đô thị: nút cách nhau ~1 km, một số đoạn bị
+ *        bỏ, một phần là đường một chiều, tốc độ ngẫu nhiên 20-80 km/h.
+ */
+static void buildGrid(RoadMap& map, int W, int H, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_real_distribution<double> U(0, 1);
+    for (int y = 0; y < H; y++)
+        for (int x = 0; x < W; x++)
+            map.addNode("N" + to_string(y * W + x), "n",
+                        12.0 + y * 0.01 + U(rng) * 0.002, 107.0 + x * 0.01 + U(rng) * 0.002);
+
+    int e = 0;
+    auto add = [&](int a, int b) {
+        if (U(rng) < 0.1) return;
+        Direction dir = U(rng) < 0.7 ? Direction::TWO_WAY : Direction::ONE_WAY;
+        map.addEdge("E" + to_string(e++), "r", 1.0 + U(rng) * 2, 20 + U(rng) * 60,
+                    "N" + to_string(a), "N" + to_string(b), dir,
+                    static_cast<RoadType>(rng() % 6));
+    };
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            int i = y * W + x;
+            if (x + 1 < W) add(i, i + 1);
+            if (y + 1 < H) add(i, i + W);
+        }
+    }
+}
+
+static void runBenchmark(const string& label, RoadMap& map, int queries) {
+    const CompactGraph& g = map.graph();
+    if (g.numNodes() < 2) return;
+
+    mt19937 rng(42);
+    vector<pair<uint32_t, uint32_t>> pairs;
+    for (int i = 0; i < queries; i++) pairs.push_back({rng() % g.numNodes(), rng() % g.numNodes()});
+
+    printf("%s: %u nodes, %u edges, %d queries\n", label.c_str(), g.numNodes(), g.numEdges(), queries);
+
+    const pair<QueueKind, const char*> kinds[] = {
+        {QueueKind::BINARY_HEAP, "binary heap (lazy)"},
+        {QueueKind::FOUR_ARY_HEAP, "4-ary heap (decrease-key)"},
+        {QueueKind::RADIX_HEAP, "radix heap"},
+        {QueueKind::BUCKET_QUEUE, "Dial buckets (1/10 s)"},
+    };
+
+    ShortestPath sp(map);
+    vector<uint32_t> edges;
+    vector<double> reference;
+    for (const auto& kind : kinds) {
+        sp.setQueue(kind.first);
+        // một lượt khởi động để workspace và hàng đợi đạt kích thước ổn định
+        sp.findShortestPath(pairs[0].first, pairs[0].second, edges);
+
+        double maxError = 0;
+        size_t mismatches = 0;      // một bên tới được, bên kia báo không có đường
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < pairs.size(); i++) {
+            double d = sp.findShortestPath(pairs[i].first, pairs[i].second, edges);
+            if (reference.size() < pairs.size()) reference.push_back(d);
+            else if ((d < 0) != (reference[i] < 0)) mismatches++;
+            else if (d >= 0) maxError = max(maxError, (d - reference[i]) * 3600.0);
+        }
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        printf("  %-28s %9.3f ms/query   max extra time %.2f s   reachability mismatches %zu\n",
+               kind.second, ms / queries, maxError, mismatches);
+    }
+    printf("\n");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            RoadMap map;
+            if (!map.loadFromFile(argv[i])) {
+                printf("Khong the tai file: %s\n", argv[i]);
+                continue;
+            }
+            runBenchmark(argv[i], map, 2000);
+        }
+        return 0;
+    }
+
+    const int sizes[][2] = {{30, 30}, {100, 100}, {300, 300}};
+    for (const auto& s : sizes) {
+        RoadMap map;
+        buildGrid(map, s[0], s[1], 1);
+        runBenchmark("grid " + to_string(s[0]) + "x" + to_string(s[1]), map, s[0] >= 300 ? 200 : 1000);
+    }
+    return 0;
+}
@@ -170,6 +170,8 @@ int main() {
     enableConsole();
 
     RoadMap map;
+    // Nhãn hub cho truy vấn thời gian đi, lưu cạnh file bản đồ ("<file>.hl")
+    HubLabels hubLabels;
 
     // Yêu cầu tên file ban đầu
     cout << GREEN << "Nhập tên file bản đồ ban đầu (hoặc để trống để bỏ qua): " << RESET;
@@ -181,6 +183,7 @@ int main() {
             cout << RED << "❌ Lỗi: Không thể tải file: " << file << RESET << "\n";
         } else {
             cout << GREEN << "✅ Tải thành công " << map.getNodeIds().size() << " Nodes và " << map.getEdges().size() << " Edges." << RESET << "\n";
+            hubLabels.loadOrBuild(file, map.graph());
             currentMapText = buildMapDisplay(map);
         }
     } else {
@@ -223,8 +226,11 @@ int main() {
                 cout << RED << "❌ Lỗi: Node Kết thúc '" << g << "' không tồn tại.\n" << RESET;
             } else {
                 ShortestPath sp(map);
+                sp.setHubLabels(&hubLabels);
                 vector<string> path;
-                double t = sp.findShortestPath(s, g, path);
+                // Nhãn hub trả lời ngay khi không có đường; chỉ tìm tuyến khi tới được
+                double t = sp.travelTime(s, g);
+                if (t >= 0) t = sp.findShortestPath(s, g, path);
                 if (t < 0) cout << RED << "💔 Không tìm thấy đường đi từ " << s << " đến " << g << "\n" << RESET;
                 else {
                     cout << GREEN << "✅ ĐƯỜNG ĐI NGẮN NHẤT ĐÃ TÌM THẤY:" << RESET << "\n";
@@ -279,6 +285,8 @@ int main() {
             getline(cin >> ws, f); 
 
             if (map.loadFromFile(f)) {
+                // Bản đồ gộp thêm file f: nhãn đi kèm f chỉ được nạp nếu khớp bản đồ gộp
+                hubLabels.loadOrBuild(f, map.graph());
                 currentMapText = buildMapDisplay(map);
                 cout << GREEN << "✅ Tải bản đồ từ " << f << " thành công. Bản đồ đã được cập nhật.\n" << RESET;
             } else {
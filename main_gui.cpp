@@ -131,10 +131,11 @@ void drawMainMenu(GuiRenderer& gui, RoadMap& map) {
     gui.addButton(Button(570, 360, 400, 50, "2. Goi y tuyen duong thay the", 2));
     gui.addButton(Button(570, 420, 400, 50, "3. Phan tich toi uu hoa giao thong", 3));
     gui.addButton(Button(570, 480, 400, 50, "4. Tai them ban do tu file", 4));
-    gui.addButton(Button(570, 540, 400, 50, "5. Thoat", 5));
+    gui.addButton(Button(570, 540, 400, 50, "5. Vung den duoc trong T phut", 5));
+    gui.addButton(Button(570, 600, 400, 50, "6. Thoat", 6));
     
     // Draw buttons
-    for (size_t i = 0; i < 5; i++) {
+    for (size_t i = 0; i < gui.buttons.size(); i++) {
         gui.drawButton(gui.buttons[i]);
     }
     
@@ -163,8 +164,9 @@ void handleShortestPath(GuiRenderer& gui, RoadMap& map) {
     
     // Find shortest path
     ShortestPath sp(map);
-    vector<string> path;
-    double time = sp.findShortestPath(start, goal, path);
+    EdgeRoute route;
+    double time = sp.findRoute(start, goal, route);
+    vector<string> path = route.nodePath(map.graph());
     
     if (time < 0) {
         showMessageDialog(gui, "Ket qua", {"Khong tim thay duong di tu " + start + " den " + goal});
@@ -187,7 +189,7 @@ void handleShortestPath(GuiRenderer& gui, RoadMap& map) {
             // Draw map with highlighted path
             gui.drawPanel(50, 80, 500, 500, "Duong di ngan nhat");
             gui.drawMap(map, 80, 120, 1.0);
-            gui.highlightPath(map, path, 80, 120, 1.0);
+            gui.highlightPath(map, route, 80, 120, 1.0);
             
             // Draw result panel
             gui.drawPanel(570, 80, 400, 500, "Ket qua");
@@ -273,7 +275,7 @@ void handleAlternativeRoute(GuiRenderer& gui, RoadMap& map) {
         // Draw map with highlighted path
         gui.drawPanel(50, 80, 500, 500, "Tuyen duong thay the");
         gui.drawMap(map, 80, 120, 1.0);
-        gui.highlightPath(map, result.path, 80, 120, 1.0);
+        gui.highlightPath(map, result.route, 80, 120, 1.0);
         
         // Draw result panel
         gui.drawPanel(570, 80, 400, 500, "Ket qua");
@@ -526,6 +528,62 @@ void handleTrafficOptimization(GuiRenderer& gui, RoadMap& map) {
 }
 
 
+void handleIsochrone(GuiRenderer& gui, RoadMap& map) {
+    string start = showInputDialog(gui, "Nhap ID Node Bat dau (Start):");
+    if (start.empty()) return;
+    
+    if (!map.hasNode(start)) {
+        showMessageDialog(gui, "Loi", {"Node bat dau '" + start + "' khong ton tai."});
+        return;
+    }
+    
+    string minutesStr = showInputDialog(gui, "Nhap thoi gian toi da (phut):");
+    if (minutesStr.empty()) return;
+    
+    double minutes = 0;
+    try {
+        minutes = stod(minutesStr);
+    } catch (...) {
+        showMessageDialog(gui, "Loi", {"Thoi gian '" + minutesStr + "' khong hop le."});
+        return;
+    }
+    
+    // travelTime() tính theo giờ
+    ShortestPath sp(map);
+    IsochroneResult iso;
+    sp.isochrone(start, minutes / 60.0, iso);
+    
+    bool done = false;
+    while (!done) {
+        SDL_Event event;
+        while (gui.pollEvent(event)) {
+            if (event.type == SDL_QUIT) {
+                return;
+            }
+            if (event.type == SDL_KEYDOWN || event.type == SDL_MOUSEBUTTONDOWN) {
+                done = true;
+            }
+        }
+        
+        gui.clear(Color(40, 40, 50));
+        
+        gui.drawPanel(50, 80, 500, 500, "Vung den duoc");
+        gui.drawMap(map, 80, 120, 1.0);
+        gui.shadeIsochrone(map, iso, 80, 120, 1.0);
+        
+        gui.drawPanel(570, 80, 400, 500, "Ket qua");
+        gui.drawText("Tu node: " + start, 590, 120, Color(255, 255, 100));
+        gui.drawText("Trong: " + minutesStr + " phut", 590, 150, Color(255, 255, 255));
+        gui.drawText("So node den duoc: " + to_string(iso.nodes.size()), 590, 190, Color(100, 255, 100));
+        gui.drawText("So Edge bien: " + to_string(iso.boundary.size()), 590, 220, Color(100, 255, 100));
+        
+        gui.drawText("Press any key to continue", 590, 520, Color(150, 150, 150));
+        
+        gui.present();
+        SDL_Delay(16);
+    }
+}
+
 void handleLoadMap(GuiRenderer& gui, RoadMap& map) {
     string filename = showInputDialog(gui, "Nhap ten file ban do:");
     if (filename.empty()) return;
@@ -603,6 +661,9 @@ int main(int argc, char* argv[]) {
                             handleLoadMap(gui, map);
                             break;
                         case 5:
+                            handleIsochrone(gui, map);
+                            break;
+                        case 6:
                             quit = true;
                             break;
                     }